@@ -0,0 +1,79 @@
+#include "AssetPack.h"
+
+#include <cstring>
+
+#include "utils/LittleEndian.hpp"
+
+static const size_t kHeaderSize = 12;
+static const size_t kEntrySize = 32;
+static const size_t kNameOffset = 16;
+
+uint32_t AssetPack::hashName(const char* name) {
+  uint32_t hash = 2166136261u;
+  for (; *name; ++name) hash = (hash ^ (uint8_t)*name) * 16777619u;
+  return hash;
+}
+
+bool AssetPack::load(const uint8_t* data, size_t size) {
+  data_ = nullptr;
+  count_ = 0;
+  if (!data || size < kHeaderSize || memcmp(data, "APAK", 4) != 0 || data[4] != 1) return false;
+  uint16_t count = readU16(data + 6);
+  uint32_t packSize = readU32(data + 8);
+  if (packSize > size || kHeaderSize + count * kEntrySize > packSize) return false;  // truncated pack
+
+  // check every payload once here, lookups then trust the index
+  const uint8_t* entry = data + kHeaderSize;
+  for (uint16_t i = 0; i < count; ++i, entry += kEntrySize) {
+    uint32_t offset = readU32(entry + 4), length = readU32(entry + 8);
+    if (offset > packSize || length > packSize - offset) return false;
+    if (entry[12] == static_cast<uint8_t>(Type::kFrames)) {
+      const uint8_t* p = data + offset;
+      if (length < 8 || !readU16(p) || !readU16(p + 2) || !readU16(p + 4)) return false;
+      uint32_t frameBytes = (readU16(p) + 7) / 8 * readU16(p + 2);
+      if (readU16(p + 4) > (length - 8) / frameBytes) return false;
+    }
+  }
+  data_ = data;
+  count_ = count;
+  return true;
+}
+
+bool AssetPack::find(const char* name, Asset* asset) const {
+  if (!count_) return false;
+  uint32_t hash = hashName(name);
+  const uint8_t* index = data_ + kHeaderSize;
+
+  // leftmost entry with this hash, then every entry sharing it
+  uint32_t lo = 0, hi = count_;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    if (readU32(index + mid * kEntrySize) < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  for (; lo < count_; ++lo) {
+    const uint8_t* entry = index + lo * kEntrySize;
+    if (readU32(entry) != hash) break;
+    if (strncmp(reinterpret_cast<const char*>(entry + kNameOffset), name, kMaxName + 1) != 0) continue;
+    asset->data = data_ + readU32(entry + 4);
+    asset->size = readU32(entry + 8);
+    asset->type = static_cast<Type>(entry[12]);
+    return true;
+  }
+  return false;
+}
+
+bool AssetPack::findFrames(const char* name, Frames* frames) const {
+  Asset asset;
+  if (!find(name, &asset) || asset.type != Type::kFrames) return false;
+  frames->width = readU16(asset.data);
+  frames->height = readU16(asset.data + 2);
+  frames->count = readU16(asset.data + 4);
+  frames->frameMs = readU16(asset.data + 6);
+  frames->data = asset.data + 8;
+  frames->frameBytes = (frames->width + 7) / 8 * frames->height;
+  return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Named assets (1-bit animations, font images, raw data) read in place from an asset pack built by tools/mkassets.py,
+ * normally a MappedRegion of the "assets" partition. Lookups return pointers into the pack: nothing is copied to RAM,
+ * and new images or animations only need the partition reflashed, not the app.
+ *
+ * Pack layout, little endian, payloads 4-byte aligned:
+ *   "APAK", u8 version (1), u8 reserved, u16 asset count, u32 pack size
+ *   count index entries of 32 bytes, sorted by hash:
+ *     u32 FNV-1a hash of the name, u32 payload offset (from the pack start), u32 payload size,
+ *     u8 type, 3 reserved bytes, char name[16] (NUL padded)
+ *   payloads
+ * A kFrames payload is u16 width, u16 height, u16 frame count, u16 frame duration (ms), then the frames,
+ * height rows of (width + 7) / 8 bytes each, MSB-first: the row format GFXcanvas1::drawBitmap() takes.
+ * A kAnimation payload is a keyframe and XOR deltas for DeltaAnimation::load(), see DeltaAnimation.h.
+ * A kFont payload is a font image of tools/mkfont.py, for FontStore::load().
+ * A kGif payload is a GIF file as is, for GifDecoder::open().
+ * A kImage payload is a PBM (P1/P4) or XBM file as is, for MonoImageDecoder::decode().
+ */
+class AssetPack {
+ public:
+  enum class Type : uint8_t {
+    kRaw = 0,
+    kFrames = 1,
+    kFont = 2,
+    kAnimation = 3,
+    kGif = 4,
+    kImage = 5,
+  };
+
+  static const int kMaxName = 15;
+
+  struct Asset {
+    const uint8_t* data = nullptr;
+    uint32_t size = 0;
+    Type type = Type::kRaw;
+  };
+
+  struct Frames {
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint16_t count = 0;
+    uint16_t frameMs = 0;
+    const uint8_t* data = nullptr;
+    uint32_t frameBytes = 0;
+
+    /* Rows of frame index % count, ready for drawBitmap(x, y, frame(i), width, height, color) */
+    const uint8_t* frame(uint32_t index) const { return data + (index % count) * frameBytes; }
+  };
+
+  AssetPack() = default;
+  AssetPack(const AssetPack&) = delete;
+  const AssetPack& operator=(const AssetPack&) = delete;
+
+  /* Use the pack at data (kept by the caller), false if it is not a valid pack */
+  bool load(const uint8_t* data, size_t size);
+
+  bool isLoaded() const { return count_ != 0; }
+  uint16_t assetCount() const { return count_; }
+
+  bool find(const char* name, Asset* asset) const;
+
+  /* find() for a kFrames asset, with its header parsed */
+  bool findFrames(const char* name, Frames* frames) const;
+
+  /* The 32-bit FNV-1a hash the index is sorted by, same as in tools/mkassets.py */
+  static uint32_t hashName(const char* name);
+
+ private:
+  const uint8_t* data_ = nullptr;
+  uint16_t count_ = 0;
+};
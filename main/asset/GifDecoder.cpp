@@ -0,0 +1,292 @@
+#include "GifDecoder.h"
+
+#include <cstring>
+
+#include "utils/LittleEndian.hpp"
+
+static const uint8_t kImageSeparator = 0x2C;
+static const uint8_t kExtensionIntroducer = 0x21;
+static const uint8_t kTrailer = 0x3B;
+static const uint8_t kGraphicControlLabel = 0xF9;
+
+// disposal methods of the graphic control extension
+static const uint8_t kDisposeBackground = 2;
+static const uint8_t kDisposePrevious = 3;
+
+bool GifDecoder::open(const uint8_t* data, size_t size) {
+  data_ = nullptr;
+  if (!data || size < 13 || (memcmp(data, "GIF87a", 6) != 0 && memcmp(data, "GIF89a", 6) != 0)) return false;
+  width_ = readU16(data + 6);
+  height_ = readU16(data + 8);
+  uint8_t packed = data[10];
+  const uint8_t* p = data + 13;
+  globalPalette_ = nullptr;
+  globalEntries_ = 0;
+  if (packed & 0x80) {
+    uint16_t entries = 2 << (packed & 7);
+    if ((size_t)(p - data) + 3 * entries > size) return false;
+    globalPalette_ = p;
+    globalEntries_ = entries;
+    p += 3 * entries;
+  }
+  if (!width_ || !height_ || width_ > INT16_MAX || height_ > INT16_MAX) return false;
+  data_ = data;
+  end_ = data + size;
+  first_ = p;
+  rewind();
+  return true;
+}
+
+void GifDecoder::rewind() {
+  pos_ = first_;
+  clearScreen_ = true;
+  disposal_ = 0;
+  delayMs_ = 0;
+}
+
+void GifDecoder::mapPalette(const uint8_t* palette, uint16_t entries, uint8_t* lit) const {
+  memset(lit, 0, 32);
+  for (uint16_t i = 0; i < entries; ++i, palette += 3) {
+    // Rec. 601 luma, in 1/256
+    if (((palette[0] * 77 + palette[1] * 150 + palette[2] * 29) >> 8) >= threshold_) lit[i >> 3] |= 1 << (i & 7);
+  }
+}
+
+bool GifDecoder::skipBlocks() {
+  while (pos_ < end_) {
+    uint8_t n = *pos_++;
+    if (!n) return true;
+    if (end_ - pos_ < n) return false;
+    pos_ += n;
+  }
+  return false;
+}
+
+GifDecoder::Rect GifDecoder::clipToCanvas(const Rect& frame) const {
+  // frame is in screen coordinates: clip it to the screen, then to the canvas
+  int32_t x0 = frame.x > 0 ? frame.x : 0, y0 = frame.y > 0 ? frame.y : 0;
+  int32_t x1 = frame.x + frame.w < width_ ? frame.x + frame.w : width_;
+  int32_t y1 = frame.y + frame.h < height_ ? frame.y + frame.h : height_;
+  x0 += originX_, x1 += originX_, y0 += originY_, y1 += originY_;
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > canvas_->width()) x1 = canvas_->width();
+  if (y1 > canvas_->height()) y1 = canvas_->height();
+  Rect rect;
+  if (x0 < x1 && y0 < y1) {
+    rect.x = x0;
+    rect.y = y0;
+    rect.w = x1 - x0;
+    rect.h = y1 - y0;
+  }
+  return rect;
+}
+
+void GifDecoder::clearRect(const Rect& rect) { canvas_->fillRawRect(rect.x, rect.y, rect.w, rect.h, 0); }
+
+// the frame only draws inside its rectangle, so saving and restoring whole bytes is exact
+void GifDecoder::saveRect(const Rect& rect) {
+  const int16_t stride = canvas_->getRowBytes();
+  const int16_t span = rect.w ? ((rect.x + rect.w - 1) >> 3) - (rect.x >> 3) + 1 : 0;
+  const uint8_t* line = canvas_->getBuffer() + rect.y * stride + (rect.x >> 3);
+  for (int16_t row = 0; row < rect.h; ++row, line += stride) memcpy(saved_ + row * span, line, span);
+}
+
+void GifDecoder::restoreRect() {
+  const Rect& rect = disposeRect_;
+  const int16_t stride = canvas_->getRowBytes();
+  const int16_t span = rect.w ? ((rect.x + rect.w - 1) >> 3) - (rect.x >> 3) + 1 : 0;
+  uint8_t* line = canvas_->getBuffer() + rect.y * stride + (rect.x >> 3);
+  for (int16_t row = 0; row < rect.h; ++row, line += stride) memcpy(line, saved_ + row * span, span);
+}
+
+bool GifDecoder::nextFrame(GFXcanvas1* canvas, int16_t x, int16_t y) {
+  if (!data_ || !canvas || canvas->getRotation() != 0) return false;
+  canvas_ = canvas;
+  originX_ = x;
+  originY_ = y;
+
+  // dispose of the previous frame
+  if (clearScreen_) {
+    Rect screen;
+    screen.w = width_;
+    screen.h = height_;
+    clearRect(clipToCanvas(screen));
+    clearScreen_ = false;
+  } else if (disposal_ == kDisposeBackground) {
+    clearRect(disposeRect_);  // the background is shown as unlit, as browsers show it transparent
+  } else if (disposal_ == kDisposePrevious) {
+    restoreRect();
+  }
+  disposal_ = 0;
+
+  uint8_t disposal = 0;
+  int16_t transparent = -1;
+  uint16_t delay = 0;
+  while (pos_ < end_) {
+    uint8_t type = *pos_++;
+    if (type == kTrailer) {
+      --pos_;  // stay at the end
+      return false;
+    }
+    if (type == kExtensionIntroducer) {
+      if (pos_ >= end_) return false;
+      uint8_t label = *pos_++;
+      if (label == kGraphicControlLabel && end_ - pos_ >= 6 && pos_[0] == 4) {
+        disposal = (pos_[1] >> 2) & 7;
+        transparent = (pos_[1] & 1) ? pos_[4] : -1;
+        delay = readU16(pos_ + 2);
+      }
+      if (!skipBlocks()) return false;
+      continue;
+    }
+    if (type != kImageSeparator || end_ - pos_ < 9) return false;
+
+    Rect frame;
+    frame.x = readU16(pos_) & INT16_MAX;
+    frame.y = readU16(pos_ + 2) & INT16_MAX;
+    frame.w = readU16(pos_ + 4) & INT16_MAX;
+    frame.h = readU16(pos_ + 6) & INT16_MAX;
+    uint8_t packed = pos_[8];
+    pos_ += 9;
+    const uint8_t* palette = globalPalette_;
+    uint16_t entries = globalEntries_;
+    if (packed & 0x80) {
+      entries = 2 << (packed & 7);
+      if (end_ - pos_ < 3 * entries) return false;
+      palette = pos_;
+      pos_ += 3 * entries;
+    }
+    uint8_t lit[32];
+    mapPalette(palette, entries, lit);
+
+    Rect clipped = clipToCanvas(frame);
+    disposal_ = disposal;
+    disposeRect_ = clipped;
+    if (disposal_ == kDisposePrevious) {
+      int16_t span = clipped.w ? ((clipped.x + clipped.w - 1) >> 3) - (clipped.x >> 3) + 1 : 0;
+      if (span * clipped.h <= kMaxSavedBytes) {
+        saveRect(clipped);
+      } else {
+        disposal_ = kDisposeBackground;
+      }
+    }
+    delayMs_ = delay ? delay * 10 : 100;
+    return decodeImage(frame, clipped, lit, transparent, packed & 0x40);
+  }
+  return false;
+}
+
+int GifDecoder::readCode() {
+  while (bitCount_ < codeSize_) {
+    if (!blockLeft_) {
+      if (pos_ >= end_) return kEndOfFile;
+      blockLeft_ = *pos_++;
+      if (!blockLeft_) {
+        --pos_;  // leave the block terminator to skipBlocks()
+        return kEndOfData;
+      }
+      if (end_ - pos_ < blockLeft_) return kEndOfFile;
+    }
+    bits_ |= (uint32_t)*pos_++ << bitCount_;
+    bitCount_ += 8;
+    --blockLeft_;
+  }
+  int code = bits_ & ((1u << codeSize_) - 1);
+  bits_ >>= codeSize_;
+  bitCount_ -= codeSize_;
+  return code;
+}
+
+bool GifDecoder::decodeImage(const Rect& frame, const Rect& clipped, const uint8_t* lit, int16_t transparent, bool interlaced) {
+  if (pos_ >= end_) return false;
+  const uint8_t minCodeSize = *pos_++;
+  if (minCodeSize < 1 || minCodeSize > 8) return false;
+  const uint16_t clear = 1 << minCodeSize, endOfInformation = clear + 1;
+  blockLeft_ = 0;
+  bits_ = 0;
+  bitCount_ = 0;
+  codeSize_ = minCodeSize + 1;
+  uint16_t next = clear + 2;
+  int prev = -1;
+  uint8_t prevFirst = 0;
+
+  // pixel cursor, in frame rows (interlaced frames come in 4 passes)
+  static const uint8_t kPassStart[4] = {0, 4, 2, 1};
+  static const uint8_t kPassStep[4] = {8, 8, 4, 2};
+  const int16_t stride = canvas_->getRowBytes();
+  const int32_t frameX = originX_ + frame.x, frameY = originY_ + frame.y;
+  uint32_t left = (uint32_t)frame.w * frame.h;
+  uint8_t pass = 0;
+  int16_t row = 0, col = 0;
+  uint8_t* line = nullptr;
+  auto startRow = [&] {
+    int32_t cy = frameY + row;
+    line = cy >= clipped.y && cy < clipped.y + clipped.h ? canvas_->getBuffer() + cy * stride : nullptr;
+  };
+  startRow();
+
+  for (;;) {
+    int code = readCode();
+    if (code == kEndOfFile) return false;
+    if (code == kEndOfData) break;  // no end code, the frame ends here
+    if (code == clear) {
+      codeSize_ = minCodeSize + 1;
+      next = clear + 2;
+      prev = -1;
+      continue;
+    }
+    if (code == endOfInformation) break;
+
+    // the string of code, last pixel first
+    int len = 0;
+    uint16_t c = code;
+    if (prev < 0) {
+      if (code > clear) return false;
+    } else {
+      if (code > next) return false;
+      if (code == next) {
+        stack_[len++] = prevFirst;
+        c = prev;
+      }
+      while (c > endOfInformation) {  // prefix_[c] < c, the walk ends
+        stack_[len++] = suffix_[c];
+        c = prefix_[c];
+      }
+      if (next >= kMaxCodes) return false;  // dictionary full: a frame too large for kMaxCodes
+      prefix_[next] = prev;
+      suffix_[next] = c;
+      if (++next == (1u << codeSize_) && codeSize_ < 12) ++codeSize_;
+    }
+    stack_[len++] = c;
+    prevFirst = c;
+    prev = code;
+
+    while (len > 0 && left > 0) {
+      uint8_t index = stack_[--len];
+      int32_t cx = frameX + col;
+      if (line && index != transparent && cx >= clipped.x && cx < clipped.x + clipped.w) {
+        if (lit[index >> 3] & (1 << (index & 7))) {
+          line[cx >> 3] |= 0x80 >> (cx & 7);
+        } else {
+          line[cx >> 3] &= ~(0x80 >> (cx & 7));
+        }
+      }
+      --left;
+      if (++col == frame.w) {
+        col = 0;
+        if (!interlaced) {
+          ++row;
+        } else {
+          row += kPassStep[pass];
+          while (row >= frame.h && pass < 3) row = kPassStart[++pass];
+        }
+        startRow();
+      }
+    }
+  }
+  // whatever follows the end code up to the block terminator is unused
+  pos_ += blockLeft_;
+  blockLeft_ = 0;
+  return skipBlocks();
+}
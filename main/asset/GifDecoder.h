@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/*
+ * Streaming GIF decoder for small 1-bit displays. Frames are read in place from the file bytes (a MappedRegion of
+ * flash or of a file on the host, or an asset of the pack) and every pixel goes straight from the LZW decoder into a
+ * GFXcanvas1: no frame buffer, no RGB. Each palette entry is lit when its luminance reaches the threshold,
+ * transparent pixels keep what is below them, and frame disposal (none, background, previous) is honoured.
+ *
+ * RAM is fixed at about 4.5 KB, in the object: the LZW dictionary holds kMaxCodes entries instead of GIF's 4096.
+ * That covers any frame up to 766 pixels (1018 for 2-color images), e.g. 32x16; larger frames decode only if the
+ * encoder sent clear codes often enough, otherwise nextFrame() fails.
+ */
+class GifDecoder {
+ public:
+  static const int kMaxCodes = 1024;
+  static const int kMaxSavedBytes = 256;  // canvas bytes saved for "restore to previous", larger frames clear instead
+
+  GifDecoder() = default;
+  GifDecoder(const GifDecoder&) = delete;
+  const GifDecoder& operator=(const GifDecoder&) = delete;
+
+  /* Use the GIF at data (kept by the caller), false if it is not a GIF */
+  bool open(const uint8_t* data, size_t size);
+
+  /* Screen size of the animation */
+  uint16_t width() const { return width_; }
+  uint16_t height() const { return height_; }
+
+  /* Palette entries with a luminance (0-255) of at least luma are lit, default 128; applies from the next frame */
+  void setThreshold(uint8_t luma) { threshold_ = luma; }
+
+  /*
+   * Draw the next frame onto the animation screen, whose top left corner is at x, y of canvas. The canvas must not
+   * be rotated and is written in buffer coordinates, clipped to its size. Pass the same canvas and position for
+   * every frame, nothing else may draw there. Returns false at the end of the animation or on broken data.
+   */
+  bool nextFrame(GFXcanvas1* canvas, int16_t x, int16_t y);
+
+  /* How long the last decoded frame is shown; a delay of 0 in the file means 100 ms, as browsers do */
+  uint16_t delayMs() const { return delayMs_; }
+
+  /* Start again from the first frame, which is drawn on a cleared screen */
+  void rewind();
+
+ private:
+  struct Rect {
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t w = 0;
+    int16_t h = 0;
+  };
+
+  void mapPalette(const uint8_t* palette, uint16_t entries, uint8_t* lit) const;
+  bool skipBlocks();
+  bool decodeImage(const Rect& frame, const Rect& clipped, const uint8_t* lit, int16_t transparent, bool interlaced);
+
+  // readCode() results besides codes
+  static const int kEndOfData = -1;  // the image data ended (block terminator)
+  static const int kEndOfFile = -2;  // the file ended
+  int readCode();
+  void clearRect(const Rect& rect);
+  void saveRect(const Rect& rect);
+  void restoreRect();
+  Rect clipToCanvas(const Rect& frame) const;
+
+  const uint8_t* data_ = nullptr;
+  const uint8_t* end_ = nullptr;
+  const uint8_t* first_ = nullptr;  // first block after the global palette
+  const uint8_t* pos_ = nullptr;
+  uint16_t width_ = 0;
+  uint16_t height_ = 0;
+  uint8_t threshold_ = 128;
+  const uint8_t* globalPalette_ = nullptr;
+  uint16_t globalEntries_ = 0;
+
+  // target of the frame being decoded
+  GFXcanvas1* canvas_ = nullptr;
+  int16_t originX_ = 0;
+  int16_t originY_ = 0;
+
+  // disposal of the previous frame, done before the next one is drawn
+  bool clearScreen_ = true;
+  uint8_t disposal_ = 0;
+  Rect disposeRect_;
+  uint8_t saved_[kMaxSavedBytes];
+  uint16_t delayMs_ = 0;
+
+  // LZW bit reader over the data sub-blocks
+  uint8_t blockLeft_ = 0;
+  uint32_t bits_ = 0;
+  uint8_t bitCount_ = 0;
+  uint8_t codeSize_ = 0;
+
+  uint16_t prefix_[kMaxCodes];
+  uint8_t suffix_[kMaxCodes];
+  uint8_t stack_[kMaxCodes];
+};
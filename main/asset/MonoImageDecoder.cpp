@@ -0,0 +1,297 @@
+#include "MonoImageDecoder.h"
+
+#include <cstring>
+
+#include "utils/ReverseBits.hpp"
+
+static bool isSpace(uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+static int hexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool endsWith(const char* s, size_t length, const char* suffix) {
+  size_t n = strlen(suffix);
+  return length >= n && memcmp(s + length - n, suffix, n) == 0;
+}
+
+// Pixels p to p + 7 of a canvas line cw pixels wide, only those in mask
+static void storeByte(uint8_t* line, int32_t p, uint8_t bits, uint8_t mask, int32_t cw) {
+  if (p <= -8 || p >= cw) return;
+  if (p < 0) {
+    bits <<= -p;
+    mask <<= -p;
+    p = 0;
+  }
+  if (p + 8 > cw) mask &= 0xFF << (p + 8 - cw);
+  const int32_t j = p >> 3;
+  const uint8_t shift = p & 7;
+  bits &= mask;
+  line[j] = (line[j] & ~(mask >> shift)) | (bits >> shift);
+  if (!shift) return;
+  const uint8_t m = mask << (8 - shift);
+  if (m) line[j + 1] = (line[j + 1] & ~m) | (uint8_t)(bits << (8 - shift));
+}
+
+void MonoImageDecoder::begin(GFXcanvas1* canvas, int16_t x, int16_t y) {
+  canvas_ = canvas;
+  x_ = x;
+  y_ = y;
+  state_ = canvas ? State::kMagic : State::kError;
+  format_ = Format::kUnknown;
+  width_ = height_ = 0;
+  row_ = rowByte_ = 0;
+  magic_ = 0;
+  comment_ = false;
+  values_ = 0;
+  value_ = 0;
+  digits_ = 0;
+  hex_ = false;
+  tokenLength_ = 0;
+  define_ = 0;
+  defineTarget_ = nullptr;
+}
+
+bool MonoImageDecoder::decode(const uint8_t* data, size_t size, GFXcanvas1* canvas, int16_t x, int16_t y) {
+  begin(canvas, x, y);
+  return feed(data, size) && done();
+}
+
+bool MonoImageDecoder::feed(const uint8_t* data, size_t size) {
+  const uint8_t* p = data;
+  const uint8_t* end = data + size;
+  while (p < end && state_ != State::kDone && state_ != State::kError) {
+    if (state_ == State::kPbm) {
+      // P4 rows, as many bytes at a time as the chunk holds
+      p += pbmRows(p, end - p);
+      continue;
+    }
+    const uint8_t c = *p++;
+    bool ok = true;
+    switch (state_) {
+      case State::kMagic:
+        if (magic_) {
+          format_ = c == '1' ? Format::kPbmText : c == '4' ? Format::kPbm : Format::kUnknown;
+          ok = format_ != Format::kUnknown;
+          state_ = State::kPbmHeader;
+        } else if (c == 'P') {
+          magic_ = c;
+        } else if (c == '#' || c == '/') {
+          // "#define name_width" or a comment before it
+          format_ = Format::kXbm;
+          state_ = State::kXbmHeader;
+          ok = xbmHeader(c);
+        } else {
+          ok = isSpace(c);
+        }
+        break;
+      case State::kPbmHeader:
+        ok = pbmHeader(c);
+        break;
+      case State::kPbmText:
+        ok = pbmText(c);
+        break;
+      case State::kXbmHeader:
+        ok = xbmHeader(c);
+        break;
+      case State::kXbmData:
+        ok = xbmData(c);
+        break;
+      default:
+        break;
+    }
+    if (!ok) state_ = State::kError;
+  }
+  return state_ != State::kError;
+}
+
+bool MonoImageDecoder::startRaster() {
+  if (!width_ || !height_ || width_ > INT16_MAX || height_ > INT16_MAX) return false;
+  rowBytes_ = (width_ + 7) / 8;
+  lastMask_ = 0xFF << ((8 - width_ % 8) % 8);
+  row_ = rowByte_ = 0;
+  bits_ = bitCount_ = 0;
+  value_ = 0;
+  digits_ = 0;
+  hex_ = false;
+  state_ = format_ == Format::kPbmText ? State::kPbmText : format_ == Format::kPbm ? State::kPbm : State::kXbmData;
+  return true;
+}
+
+bool MonoImageDecoder::pbmHeader(uint8_t c) {
+  if (comment_) {
+    comment_ = c != '\n' && c != '\r';
+    return true;
+  }
+  if (c >= '0' && c <= '9') {
+    value_ = value_ * 10 + (c - '0');
+    ++digits_;
+    return value_ <= INT16_MAX;
+  }
+  const bool number = digits_ != 0;
+  if (number) {
+    if (values_++ == 0) {
+      width_ = value_;
+    } else {
+      height_ = value_;
+    }
+    value_ = 0;
+    digits_ = 0;
+  }
+  if (c == '#') {
+    comment_ = true;
+  } else if (!isSpace(c)) {
+    return false;
+  }
+  // the raster starts after the single whitespace that ends the height
+  if (number && values_ == 2) {
+    comment_ = false;
+    return startRaster();
+  }
+  return true;
+}
+
+bool MonoImageDecoder::pbmText(uint8_t c) {
+  if (isSpace(c)) return true;
+  if (c != '0' && c != '1') return false;
+  if (c == '1') bits_ |= 0x80 >> bitCount_;
+  if (++bitCount_ == 8 || rowByte_ * 8 + bitCount_ == width_) {
+    putByte(bits_);
+    bits_ = 0;
+    bitCount_ = 0;
+  }
+  return true;
+}
+
+size_t MonoImageDecoder::pbmRows(const uint8_t* data, size_t size) {
+  size_t used = 0;
+  while (used < size && state_ != State::kDone) {
+    // rows exactly as wide as the canvas lie back to back on both sides: all whole ones in one memcpy
+    const int32_t cy = y_ + row_;
+    if (!rowByte_ && !x_ && width_ == canvas_->width() && lastMask_ == 0xFF && cy >= 0) {
+      uint32_t rows = (size - used) / rowBytes_;
+      if (rows > (uint32_t)(height_ - row_)) rows = height_ - row_;
+      if (cy + rows > (uint32_t)canvas_->height()) rows = cy < canvas_->height() ? canvas_->height() - cy : 0;
+      if (rows) {
+        memcpy(canvas_->getBuffer() + cy * rowBytes_, data + used, rows * rowBytes_);
+        used += rows * rowBytes_;
+        row_ += rows;
+        if (row_ == height_) state_ = State::kDone;
+        continue;
+      }
+    }
+    uint16_t n = rowBytes_ - rowByte_;
+    if (n > size - used) n = size - used;
+    putRowBytes(rowByte_, data + used, n);
+    used += n;
+    rowByte_ += n;
+    if (rowByte_ == rowBytes_) {
+      rowByte_ = 0;
+      if (++row_ == height_) state_ = State::kDone;
+    }
+  }
+  return used;
+}
+
+bool MonoImageDecoder::xbmHeader(uint8_t c) {
+  if (!isSpace(c) && !strchr("{}[]=;,", c)) {
+    if (tokenLength_ == kMaxToken) memmove(token_, token_ + 1, --tokenLength_);
+    token_[tokenLength_++] = c;
+    return true;
+  }
+  if (tokenLength_) {
+    token_[tokenLength_] = 0;
+    xbmToken();
+    tokenLength_ = 0;
+  }
+  // the array: static unsigned char name_bits[] = { 0x00, ... };
+  return c != '{' || startRaster();
+}
+
+void MonoImageDecoder::xbmToken() {
+  switch (define_) {
+    case 1:
+      // #define name_width 16, #define name_height 8
+      defineTarget_ = endsWith(token_, tokenLength_, "_width") ? &width_ : endsWith(token_, tokenLength_, "_height") ? &height_ : nullptr;
+      define_ = 2;
+      return;
+    case 2:
+      if (defineTarget_) {
+        uint32_t v = 0;
+        for (uint8_t i = 0; i < tokenLength_ && v <= INT16_MAX; ++i) v = token_[i] >= '0' && token_[i] <= '9' ? v * 10 + (token_[i] - '0') : UINT32_MAX;
+        *defineTarget_ = v <= INT16_MAX ? v : 0;
+      }
+      define_ = 0;
+      return;
+    default:
+      if (strcmp(token_, "#define") == 0) define_ = 1;
+      return;
+  }
+}
+
+bool MonoImageDecoder::xbmData(uint8_t c) {
+  if ((c == 'x' || c == 'X') && !hex_ && digits_ == 1 && value_ == 0) {
+    hex_ = true;
+    digits_ = 0;
+    return true;
+  }
+  const int d = hexValue(c);
+  if (d >= 0 && (hex_ || d < 10)) {
+    value_ = value_ * (hex_ ? 16 : 10) + d;
+    ++digits_;
+    return value_ <= 0xFF;  // X11 bytes, not the shorts of X10 files
+  }
+  if (c != ',' && c != '}' && !isSpace(c)) return false;
+  if (digits_) {
+    putByte(reverseBits((uint8_t)value_));  // XBM stores the leftmost pixel in the lowest bit
+    value_ = 0;
+    digits_ = 0;
+    hex_ = false;
+  } else if (hex_) {
+    return false;  // "0x" alone
+  }
+  // the array ended early
+  return c != '}' || state_ == State::kDone;
+}
+
+void MonoImageDecoder::putByte(uint8_t bits) {
+  putRowBytes(rowByte_, &bits, 1);
+  if (++rowByte_ < rowBytes_) return;
+  rowByte_ = 0;
+  if (++row_ == height_) state_ = State::kDone;
+}
+
+void MonoImageDecoder::putRowBytes(uint16_t first, const uint8_t* src, uint16_t n) {
+  const int32_t cy = y_ + row_;
+  if (cy < 0 || cy >= canvas_->height()) return;
+  uint8_t* line = canvas_->getBuffer() + cy * canvas_->getRowBytes();
+  const int32_t cw = canvas_->width();
+  const int32_t px = x_ + first * 8;  // canvas x of src[0]
+  // bytes k0 to k1 - 1 land entirely inside the canvas (and the image, the padding of the last byte stays out)
+  const int32_t left = px < 0 ? (7 - px) / 8 : 0;
+  const int32_t fit = cw > px ? (cw - px) / 8 : 0;
+  const uint16_t k0 = left < n ? left : n;
+  uint16_t k1 = fit < n ? fit : n;
+  if (k1 && first + k1 == rowBytes_ && lastMask_ != 0xFF) --k1;
+  uint16_t k = k0 ? k0 - 1 : 0;  // the byte across the left edge
+  if (k1 > k0) {
+    for (; k < k0; ++k) storeByte(line, px + 8 * k, src[k], 0xFF, cw);
+    uint8_t* dst = line + ((px + 8 * k0) >> 3);
+    const uint8_t shift = px & 7;
+    if (!shift) {
+      memcpy(dst, src + k0, k1 - k0);
+    } else {
+      // every destination byte takes the end of one source byte and the start of the next
+      *dst = (*dst & ~(0xFF >> shift)) | (src[k0] >> shift);
+      for (k = k0 + 1; k < k1; ++k) *++dst = (src[k - 1] << (8 - shift)) | (src[k] >> shift);
+      ++dst;
+      const uint8_t mask = 0xFF << (8 - shift);
+      *dst = (*dst & ~mask) | (uint8_t)(src[k1 - 1] << (8 - shift));
+    }
+    k = k1;
+  }
+  for (; k < n && px + 8 * k < cw; ++k) storeByte(line, px + 8 * k, src[k], first + k + 1 == rowBytes_ ? lastMask_ : 0xFF, cw);
+}
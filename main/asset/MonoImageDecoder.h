@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/*
+ * Streaming decoder of 1-bit image files: PBM (P1 text and P4 binary) and X11 XBM (the C source of drawXBitmap()
+ * arrays). The file is pushed in chunks of any size as they arrive (a MappedRegion or an asset of the pack at once,
+ * or the buffers of a file or network read) and each row goes straight into the canvas rows: there is no image
+ * buffer, the decoder itself is a few dozen bytes of state.
+ *
+ * P4 rows already are the canvas row format (MSB-first, rows padded to whole bytes): at a byte aligned x they are
+ * copied with memcpy, otherwise shifted a byte at a time. tools/png2mono.py converts PNG images to P4 or XBM.
+ *
+ * Set pixels (1 in both formats) are lit, the image is drawn opaque: its 0 pixels clear the canvas.
+ */
+class MonoImageDecoder {
+ public:
+  enum class Format : uint8_t {
+    kUnknown = 0,  // nothing decoded yet
+    kPbmText,      // P1
+    kPbm,          // P4
+    kXbm,
+  };
+
+  MonoImageDecoder() = default;
+  MonoImageDecoder(const MonoImageDecoder&) = delete;
+  const MonoImageDecoder& operator=(const MonoImageDecoder&) = delete;
+
+  /*
+   * Start a new file, whose top left corner goes to x, y of canvas. The canvas must not be rotated and is written in
+   * buffer coordinates, clipped to its size.
+   */
+  void begin(GFXcanvas1* canvas, int16_t x, int16_t y);
+
+  /*
+   * Decode the next size bytes of the file. Rows are drawn as soon as their bytes arrived, bytes after the image
+   * are ignored. Returns false on broken data or an unsupported file (also for every later call).
+   */
+  bool feed(const uint8_t* data, size_t size);
+
+  /* A whole file at once: begin() and feed(), false unless the image is complete */
+  bool decode(const uint8_t* data, size_t size, GFXcanvas1* canvas, int16_t x, int16_t y);
+
+  /* The whole image was drawn */
+  bool done() const { return state_ == State::kDone; }
+
+  /* Known once the header was read, 0 before */
+  Format format() const { return format_; }
+  uint16_t width() const { return width_; }
+  uint16_t height() const { return height_; }
+
+  /* Rows drawn so far */
+  uint16_t rowsDone() const { return row_; }
+
+ private:
+  enum class State : uint8_t {
+    kMagic,
+    kPbmHeader,
+    kPbmText,
+    kPbm,
+    kXbmHeader,
+    kXbmData,
+    kDone,
+    kError,
+  };
+
+  static const int kMaxToken = 48;  // XBM header words keep their last kMaxToken characters
+
+  bool startRaster();
+  bool pbmHeader(uint8_t c);
+  bool pbmText(uint8_t c);
+  size_t pbmRows(const uint8_t* data, size_t size);
+  bool xbmHeader(uint8_t c);
+  void xbmToken();
+  bool xbmData(uint8_t c);
+
+  /* Next byte of the current row, P1 and XBM */
+  void putByte(uint8_t bits);
+  /* Bytes first to first + n - 1 of the current row */
+  void putRowBytes(uint16_t first, const uint8_t* src, uint16_t n);
+
+  GFXcanvas1* canvas_ = nullptr;
+  int16_t x_ = 0;
+  int16_t y_ = 0;
+  State state_ = State::kError;
+  Format format_ = Format::kUnknown;
+  uint16_t width_ = 0;
+  uint16_t height_ = 0;
+  uint16_t rowBytes_ = 0;
+  uint8_t lastMask_ = 0;  // image pixels of a row's last byte
+
+  // raster position
+  uint16_t row_ = 0;
+  uint16_t rowByte_ = 0;
+  uint8_t bits_ = 0;  // P1 byte being assembled
+  uint8_t bitCount_ = 0;
+
+  // header and XBM number parsing
+  uint8_t magic_ = 0;
+  bool comment_ = false;
+  uint8_t values_ = 0;  // PBM header numbers read
+  uint32_t value_ = 0;
+  uint8_t digits_ = 0;
+  bool hex_ = false;
+  char token_[kMaxToken + 1];
+  uint8_t tokenLength_ = 0;
+  uint8_t define_ = 0;  // XBM: words since the last #define
+  uint16_t* defineTarget_ = nullptr;
+};
@@ -0,0 +1,75 @@
+#include "FontStore.h"
+
+#include <cstring>
+
+#include "utils/LittleEndian.hpp"
+
+static const size_t kHeaderSize = 12;
+
+bool FontStore::load(const uint8_t* data, size_t size) {
+  count_ = 0;
+  for (auto& entry : cache_) entry.lastUse = 0;
+  useCounter_ = 0;
+
+  if (!data || size < kHeaderSize || memcmp(data, "UFNT", 4) != 0 || data[4] != 1) return false;
+  uint8_t width = data[5], height = data[6];
+  uint32_t count = readU32(data + 8);
+  uint16_t glyphBytes = (width + 7) / 8 * height;
+  if (!width || !height || glyphBytes > kMaxGlyphBytes) return false;
+  if (count > (size - kHeaderSize) / (4 + 1 + glyphBytes)) return false;  // truncated image
+
+  width_ = width;
+  height_ = height;
+  yAdvance_ = data[7];
+  glyphBytes_ = glyphBytes;
+  index_ = data + kHeaderSize;
+  advances_ = index_ + 4 * count;
+  bitmaps_ = advances_ + count;
+  count_ = count;
+  return true;
+}
+
+int32_t FontStore::find(uint32_t codepoint) const {
+  uint32_t lo = 0, hi = count_;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    uint32_t value = readU32(index_ + 4 * mid);
+    if (value == codepoint) return mid;
+    if (value < codepoint) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return -1;
+}
+
+bool FontStore::getGlyph(uint32_t codepoint, GFXunicodeGlyph* glyph) {
+  if (!count_) return false;
+
+  Entry* hit = nullptr;
+  Entry* victim = &cache_[0];
+  for (auto& entry : cache_) {
+    if (entry.lastUse && entry.codepoint == codepoint) {
+      hit = &entry;
+      break;
+    }
+    if (entry.lastUse < victim->lastUse) victim = &entry;
+  }
+
+  if (!hit) {
+    int32_t i = find(codepoint);
+    if (i < 0) return false;
+    hit = victim;
+    hit->codepoint = codepoint;
+    hit->xAdvance = advances_[i];
+    memcpy(hit->bitmap, bitmaps_ + (size_t)i * glyphBytes_, glyphBytes_);
+  }
+  hit->lastUse = ++useCounter_;
+
+  glyph->bitmap = hit->bitmap;
+  glyph->width = width_;
+  glyph->height = height_;
+  glyph->xAdvance = hit->xAdvance;
+  return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gfx/unicodefont.h"
+
+/*
+ * Bitmap font for any Unicode code point (e.g. GB2312 hanzi at 12x12 or 16x16), read in place from a font image
+ * built by tools/mkfont.py, normally a MappedRegion of the "font" partition.
+ * Recently drawn glyphs are copied into a small LRU cache in RAM, so a redraw of the same text neither
+ * searches the index nor goes through the flash cache again.
+ *
+ * Image layout, little endian:
+ *   "UFNT", u8 version (1), u8 cell width, u8 cell height, u8 yAdvance, u32 glyph count
+ *   u32 codepoint[count], sorted ascending
+ *   u8 xAdvance[count]
+ *   count bitmaps of height rows, (width + 7) / 8 bytes per row, MSB-first
+ */
+class FontStore : public GFXunicodeFont {
+ public:
+  static const int kCacheSize = 16;
+  static const int kMaxGlyphBytes = 3 * 24;  // up to 24x24 cells
+
+  FontStore() = default;
+  FontStore(const FontStore&) = delete;
+  const FontStore& operator=(const FontStore&) = delete;
+
+  /* Use the image at data (kept by the caller), false if it is not a valid font image */
+  bool load(const uint8_t* data, size_t size);
+
+  bool isLoaded() const { return count_ != 0; }
+  uint32_t glyphCount() const { return count_; }
+
+  bool getGlyph(uint32_t codepoint, GFXunicodeGlyph* glyph) override;
+  uint8_t yAdvance() const override { return yAdvance_; }
+
+ private:
+  struct Entry {
+    uint32_t codepoint = 0;
+    uint32_t lastUse = 0;  // 0: empty
+    uint8_t xAdvance = 0;
+    uint8_t bitmap[kMaxGlyphBytes];
+  };
+
+  int32_t find(uint32_t codepoint) const;
+
+  const uint8_t* index_ = nullptr;  // u32 codepoints
+  const uint8_t* advances_ = nullptr;
+  const uint8_t* bitmaps_ = nullptr;
+  uint32_t count_ = 0;
+  uint8_t width_ = 0;
+  uint8_t height_ = 0;
+  uint8_t yAdvance_ = 0;
+  uint16_t glyphBytes_ = 0;
+
+  Entry cache_[kCacheSize];
+  uint32_t useCounter_ = 0;
+};
@@ -0,0 +1,67 @@
+#include "MappedRegion.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_log.h>
+#include <esp_partition.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedRegion::~MappedRegion() { unmap(); }
+
+#ifdef ESP_PLATFORM
+
+static const char* TAG = "MappedRegion";
+
+bool MappedRegion::mapPartition(const char* label) {
+  unmap();
+  const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (!partition) {
+    ESP_LOGW(TAG, "no partition '%s'", label);
+    return false;
+  }
+  const void* ptr;
+  esp_err_t err = esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &ptr, &handle_);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "mmap '%s' failed: %s", label, esp_err_to_name(err));
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(ptr);
+  size_ = partition->size;
+  return true;
+}
+
+void MappedRegion::unmap() {
+  if (data_) spi_flash_munmap(handle_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#else
+
+bool MappedRegion::mapFile(const char* path) {
+  unmap();
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st {};
+  void* ptr = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);  // the mapping keeps the file referenced
+  if (ptr == MAP_FAILED) return false;
+  data_ = static_cast<const uint8_t*>(ptr);
+  size_ = st.st_size;
+  return true;
+}
+
+void MappedRegion::unmap() {
+  if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
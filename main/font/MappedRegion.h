@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef ESP_PLATFORM
+#include <esp_spi_flash.h>
+#endif
+
+/*
+ * Read-only view of a flash data partition, mapped into the data address space through the flash cache/MMU.
+ * Off-device the same data comes from a file mapped with mmap(), so code reading fonts or assets runs unchanged on the host.
+ */
+class MappedRegion {
+ public:
+  MappedRegion() = default;
+  MappedRegion(const MappedRegion&) = delete;
+  const MappedRegion& operator=(const MappedRegion&) = delete;
+  ~MappedRegion();
+
+#ifdef ESP_PLATFORM
+  /* Map the whole data partition with this label, false if missing or the mapping failed */
+  bool mapPartition(const char* label);
+#else
+  /* Map a whole file, e.g. the partition image written by tools/ */
+  bool mapFile(const char* path);
+#endif
+
+  void unmap();
+
+  bool isMapped() const { return data_ != nullptr; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef ESP_PLATFORM
+  spi_flash_mmap_handle_t handle_ = 0;
+#endif
+};
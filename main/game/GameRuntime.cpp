@@ -0,0 +1,44 @@
+#include "GameRuntime.h"
+
+void Game::renderGameOver(GFXcanvas1* canvas) const {
+  canvas->fillScreen(0);
+  canvas->drawRect(0, 0, canvas->width(), canvas->height(), 1);
+  canvas->setCursor(4, 4);
+  canvas->printNumber(score_, 4, ' ');
+}
+
+void GameRuntime::stop() {
+  if (game_) game_->~Game();
+  game_ = nullptr;
+}
+
+bool GameRuntime::advance(uint32_t elapsedMs, uint8_t held) {
+  if (!game_) return false;
+  elapsed_ += elapsedMs;
+  if (elapsed_ > kMaxCatchUp * kTickMs) elapsed_ = kMaxCatchUp * kTickMs;
+
+  bool changed = false;
+  for (; elapsed_ >= kTickMs; elapsed_ -= kTickMs) {
+    GameInput input;
+    input.held = held;
+    input.pressed = pressed_;
+    pressed_ = 0;  // a press counts for one tick only
+    if (game_->over()) {
+      if (input.isPressed(kButtonUp)) {
+        game_->reset();
+        changed = true;
+      } else if (input.isPressed(kButtonDown)) {
+        nextRequested_ = true;
+      }
+      continue;
+    }
+    changed |= game_->update(input);
+  }
+  return changed;
+}
+
+bool GameRuntime::takeNextRequest() {
+  bool requested = nextRequested_;
+  nextRequested_ = false;
+  return requested;
+}
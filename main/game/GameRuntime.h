@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "gfx/Adafruit_GFX.h"
+#include "utils/XorShift32.hpp"
+
+/* Buttons as games see them, bit masks */
+enum GameButton : uint8_t {
+  kButtonUp = 1,
+  kButtonDown = 2,
+  kButtonLeft = 4,
+  kButtonRight = 8,
+};
+
+/* Input of one tick */
+struct GameInput {
+  uint8_t held = 0;     // buttons down at the tick
+  uint8_t pressed = 0;  // buttons pressed since the previous tick, even if already released again
+
+  bool isHeld(uint8_t buttons) const { return held & buttons; }
+  bool isPressed(uint8_t buttons) const { return pressed & buttons; }
+};
+
+/**
+ * A game: all its state lives in the object, which the runtime keeps in its arena, and a tick never allocates.
+ */
+class Game {
+ public:
+  Game() = default;
+  virtual ~Game() = default;
+  Game(const Game&) = delete;
+  const Game& operator=(const Game&) = delete;
+
+  /* Start a new round */
+  virtual void reset() = 0;
+
+  /* Advance one fixed tick, returns true if the picture changed */
+  virtual bool update(const GameInput& input) = 0;
+
+  /* Draw the whole screen */
+  virtual void render(GFXcanvas1* canvas) const = 0;
+
+  bool over() const { return over_; }
+  uint16_t score() const { return score_; }
+
+ protected:
+  /* 0 - n-1 */
+  uint32_t random(uint32_t n) { return random_.below(n); }
+
+  /* The score screen shown once the game is over */
+  void renderGameOver(GFXcanvas1* canvas) const;
+
+  bool over_ = false;
+  uint16_t score_ = 0;
+  XorShift32 random_;
+};
+
+/**
+ * Runs one game at a time at a fixed tick rate, with no heap: the game is constructed in a static arena inside
+ * the runtime. Button presses are collected as they arrive and handed to the next tick as a snapshot, together
+ * with the buttons held at that moment; the caller wakes up at the tick time (msUntilNextTick()) or at a press,
+ * so a press shows up on the panel within one tick.
+ *
+ * Once a game is over, Up starts it again and Down asks for the next game (takeNextRequest()).
+ */
+class GameRuntime {
+ public:
+  static const uint32_t kTickMs = 20;
+  static const uint8_t kMaxCatchUp = 5;  // ticks run at most per advance(), a longer stall is dropped
+  static const size_t kArenaBytes = 1536;
+
+  GameRuntime() = default;
+  ~GameRuntime() { stop(); }
+  GameRuntime(const GameRuntime&) = delete;
+  const GameRuntime& operator=(const GameRuntime&) = delete;
+
+  /* Replace the running game by a new G(args...) */
+  template <class G, class... Args>
+  G* start(Args&&... args) {
+    static_assert(sizeof(G) <= kArenaBytes, "game state does not fit the arena");
+    static_assert(alignof(G) <= alignof(std::max_align_t), "game state alignment");
+    stop();
+    G* game = new (arena_) G(std::forward<Args>(args)...);
+    game_ = game;
+    elapsed_ = 0;
+    pressed_ = 0;
+    return game;
+  }
+
+  void stop();
+
+  /* Running game or null */
+  Game* game() { return game_; }
+
+  /* Buttons (GameButton) were pressed */
+  void press(uint8_t buttons) { pressed_ |= buttons; }
+
+  /*
+   * Run the ticks due after elapsedMs more milliseconds.
+   * Params :
+   * held	buttons down now (GameButton)
+   * Returns true if the game picture changed.
+   */
+  bool advance(uint32_t elapsedMs, uint8_t held);
+
+  /* Time to wait for the next tick */
+  uint32_t msUntilNextTick() const { return elapsed_ < kTickMs ? kTickMs - elapsed_ : 0; }
+
+  /* Whether Down was pressed on the game over screen since the last call */
+  bool takeNextRequest();
+
+ private:
+  alignas(std::max_align_t) uint8_t arena_[kArenaBytes];
+  Game* game_ = nullptr;
+  uint32_t elapsed_ = 0;  // time since the last tick
+  uint8_t pressed_ = 0;
+  bool nextRequested_ = false;
+};
@@ -0,0 +1,239 @@
+#include "Games.h"
+
+static uint8_t clampSize(uint8_t v, uint8_t low, uint8_t high) { return v < low ? low : v > high ? high : v; }
+
+// a 3x1 brick with the gap right of it and the free row below
+static const uint8_t kBrickTile[] = {0xE0, 0x00};
+static const SpriteSheet brickSheet(kBrickTile, nullptr, 4, 2, 1);
+
+SnakeGame::SnakeGame(uint8_t w, uint8_t h, uint32_t seed)
+    : body_(clampSize(w, 4, 32), clampSize(h, 4, kMaxLength / clampSize(w, 4, 32))) {
+  random_.seed(seed);
+  reset();
+}
+
+void SnakeGame::reset() {
+  body_.clear();
+  over_ = false;
+  score_ = 0;
+  // three cells in the middle, heading right
+  const uint8_t y = body_.height() / 2;
+  tail_ = 0;
+  length_ = 3;
+  for (uint8_t i = 0; i < length_; ++i) {
+    uint8_t x = body_.width() / 2 - 2 + i;
+    cells_[i] = y * 32 + x;
+    body_.set(x, y);
+  }
+  dx_ = 1;
+  dy_ = 0;
+  turnCount_ = 0;
+  growth_ = 0;
+  stepTicks_ = 8;
+  wait_ = stepTicks_;
+  placeFood();
+}
+
+void SnakeGame::queueTurn(int8_t dx, int8_t dy) {
+  if (turnCount_ >= 2) return;
+  // against the direction the snake will have when this turn is taken
+  const int8_t lastX = turnCount_ ? turns_[turnCount_ - 1][0] : dx_;
+  const int8_t lastY = turnCount_ ? turns_[turnCount_ - 1][1] : dy_;
+  if ((dx == lastX && dy == lastY) || (dx == -lastX && dy == -lastY)) return;
+  turns_[turnCount_][0] = dx;
+  turns_[turnCount_][1] = dy;
+  ++turnCount_;
+}
+
+bool SnakeGame::placeFood() {
+  const uint16_t free = body_.width() * body_.height() - body_.count();
+  if (!free) return false;
+  // the n-th free cell, counted a row word at a time
+  uint16_t n = random(free);
+  const uint32_t mask = ~0u << (32 - body_.width());
+  for (uint8_t y = 0; y < body_.height(); ++y) {
+    uint32_t empty = ~body_.row(y) & mask;
+    const uint8_t inRow = __builtin_popcount(empty);
+    if (n >= inRow) {
+      n -= inRow;
+      continue;
+    }
+    for (; n; --n) empty &= empty - 1;  // drop the lowest n (rightmost) free cells
+    foodX_ = 31 - __builtin_ctz(empty);
+    foodY_ = y;
+    return true;
+  }
+  return false;
+}
+
+bool SnakeGame::update(const GameInput& input) {
+  if (input.isPressed(kButtonUp)) queueTurn(0, -1);
+  if (input.isPressed(kButtonDown)) queueTurn(0, 1);
+  if (input.isPressed(kButtonLeft)) queueTurn(-1, 0);
+  if (input.isPressed(kButtonRight)) queueTurn(1, 0);
+
+  const bool blink = (++ticks_ & 7) == 0;
+  // a turn moves at once, the player sees the press on the next frame
+  if (--wait_ && !turnCount_) return blink;
+  wait_ = stepTicks_;
+
+  if (turnCount_) {
+    dx_ = turns_[0][0];
+    dy_ = turns_[0][1];
+    turns_[0][0] = turns_[1][0];
+    turns_[0][1] = turns_[1][1];
+    --turnCount_;
+  }
+
+  const uint16_t head = cells_[(tail_ + length_ - 1) % kMaxLength];
+  const int16_t x = head % 32 + dx_, y = head / 32 + dy_;
+  if (growth_) {
+    --growth_;
+    ++length_;
+  } else {
+    // the tail moves away first, so the head may take its cell
+    const uint16_t tail = cells_[tail_];
+    body_.set(tail % 32, tail / 32, false);
+    tail_ = (tail_ + 1) % kMaxLength;
+  }
+  if (x < 0 || y < 0 || x >= body_.width() || y >= body_.height() || body_.test(x, y)) {
+    over_ = true;
+    return true;
+  }
+  body_.set(x, y);
+  cells_[(tail_ + length_ - 1) % kMaxLength] = y * 32 + x;
+
+  if (x == foodX_ && y == foodY_) {
+    ++score_;
+    growth_ += 2;
+    if (stepTicks_ > 3 && score_ % 3 == 0) --stepTicks_;
+    if (!placeFood() || length_ + growth_ >= kMaxLength) over_ = true;  // the board is full
+  }
+  return true;
+}
+
+void SnakeGame::render(GFXcanvas1* canvas) const {
+  if (over_) {
+    renderGameOver(canvas);
+    return;
+  }
+  canvas->fillScreen(0);
+  body_.render(canvas);
+  if (ticks_ & 8) canvas->drawPixel(foodX_, foodY_, 1);
+}
+
+BreakoutGame::BreakoutGame(uint8_t w, uint8_t h, uint32_t seed)
+    : width_(clampSize(w, 16, 32)), height_(clampSize(h, 8, 32)), bricks_(&brickSheet, brickCells_, (width_ + 1) / 4, kBrickRows) {
+  random_.seed(seed);
+  reset();
+}
+
+void BreakoutGame::reset() {
+  over_ = false;
+  score_ = 0;
+  lives_ = 3;
+  speed_ = 80;  // 16 pixels per second
+  paddleX_ = (width_ - kPaddleWidth) / 2;
+  buildWall();
+  serve();
+}
+
+void BreakoutGame::buildWall() {
+  // bricks of 3x1 pixels with a gap of 1, rows 1, 3 and 5: the map is drawn one pixel down
+  for (int16_t row = 0; row < bricks_.rows(); ++row) {
+    for (int16_t col = 0; col < bricks_.cols(); ++col) bricks_.setCell(col, row, 0);
+  }
+  bricksLeft_ = bricks_.rows() * bricks_.cols();
+}
+
+void BreakoutGame::serve() {
+  launched_ = false;
+  speedY_ = -speed_;
+  speedX_ = random(2) ? speed_ * 3 / 4 : -speed_ * 3 / 4;
+}
+
+bool BreakoutGame::hitBrick(int16_t x, int16_t y) {
+  --y;  // map pixel
+  if (bricks_.cellAt(x, y) == TileMap::kEmpty || x % 4 == 3 || y % 2) return false;
+  bricks_.setCell(x / 4, y / 2, TileMap::kEmpty);
+  --bricksLeft_;
+  ++score_;
+  return true;
+}
+
+bool BreakoutGame::update(const GameInput& input) {
+  const int16_t w = width_, h = height_;
+  const int16_t lastPaddle = paddleX_;
+  const int16_t lastX = ballX_ >> 8, lastY = ballY_ >> 8;
+  ++ticks_;
+
+  // a press moves at once, holding moves a pixel every other tick
+  const bool move = (ticks_ & 1) == 0;
+  if (input.isPressed(kButtonLeft) || (move && input.isHeld(kButtonLeft))) --paddleX_;
+  if (input.isPressed(kButtonRight) || (move && input.isHeld(kButtonRight))) ++paddleX_;
+  if (paddleX_ < 0) paddleX_ = 0;
+  if (paddleX_ > w - kPaddleWidth) paddleX_ = w - kPaddleWidth;
+
+  if (!launched_) {
+    // the ball rides on the paddle
+    ballX_ = (paddleX_ + kPaddleWidth / 2) << 8;
+    ballY_ = (h - 2) << 8;
+    if (input.isPressed(kButtonUp)) launched_ = true;
+    return paddleX_ != lastPaddle;
+  }
+
+  bool changed = false;
+  // horizontal, then vertical, so a corner hit bounces both ways
+  int32_t nextX = ballX_ + speedX_;
+  int16_t px = nextX >> 8, py = ballY_ >> 8;
+  if (px < 0 || px >= w || hitBrick(px, py)) {
+    speedX_ = -speedX_;
+    changed = true;
+  } else {
+    ballX_ = nextX;
+  }
+
+  int32_t nextY = ballY_ + speedY_;
+  px = ballX_ >> 8;
+  py = nextY >> 8;
+  if (nextY < 0 || hitBrick(px, py)) {
+    speedY_ = -speedY_;
+    changed = true;
+  } else if (py == h - 1 && speedY_ > 0 && px >= paddleX_ && px < paddleX_ + kPaddleWidth) {
+    // the paddle edges send the ball out flatter and faster sideways
+    const int16_t offset = 2 * (px - paddleX_) - (kPaddleWidth - 1);
+    speedY_ = -speedY_;
+    speedX_ = speed_ * offset / (kPaddleWidth - 1);
+    changed = true;
+  } else if (py >= h) {
+    if (--lives_ == 0) {
+      over_ = true;
+      return true;
+    }
+    serve();
+    return true;
+  } else {
+    ballY_ = nextY;
+  }
+
+  if (bricksLeft_ == 0) {
+    // next wall, faster, up to a pixel per tick (the ball must not skip over a brick)
+    if (speed_ < 240) speed_ += 16;
+    buildWall();
+    serve();
+    return true;
+  }
+  return changed || paddleX_ != lastPaddle || (ballX_ >> 8) != lastX || (ballY_ >> 8) != lastY;
+}
+
+void BreakoutGame::render(GFXcanvas1* canvas) const {
+  if (over_) {
+    renderGameOver(canvas);
+    return;
+  }
+  bricks_.draw(canvas, 0, -1);
+  canvas->drawFastHLine(paddleX_, height_ - 1, kPaddleWidth, 1);
+  canvas->drawPixel(ballX_ >> 8, ballY_ >> 8, 1);
+  // balls left, top right
+  for (uint8_t i = 1; i < lives_; ++i) canvas->drawPixel(width_ - 2 * i, 0, 1);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+#include "GameRuntime.h"
+#include "matrix/Bitboard.h"
+#include "matrix/Sprites.h"
+
+/**
+ * Snake: steer with the four buttons, eat the blinking food to grow; the walls and the snake's own body end the
+ * round. One cell per pixel, the body is a Bitboard (the collision test) plus a ring of its cells (to move the tail).
+ * It speeds up as it grows.
+ */
+class SnakeGame : public Game {
+ public:
+  static const int kMaxLength = 32 * 16;
+
+  /* w and h are clamped to 4 - 32, and w * h to kMaxLength (the height is cut) */
+  SnakeGame(uint8_t w, uint8_t h, uint32_t seed);
+
+  void reset() override;
+  bool update(const GameInput& input) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  void queueTurn(int8_t dx, int8_t dy);
+  bool placeFood();
+
+  Bitboard body_;
+  uint16_t cells_[kMaxLength];  // ring of y * 32 + x, tail first
+  uint16_t tail_ = 0;           // ring index of the tail
+  uint16_t length_ = 0;
+  int8_t dx_ = 1;
+  int8_t dy_ = 0;
+  int8_t turns_[2][2];  // queued turns, two quick presses make a U-turn
+  uint8_t turnCount_ = 0;
+  uint8_t growth_ = 0;  // cells still to grow
+  uint8_t stepTicks_ = 0;
+  uint8_t wait_ = 0;    // ticks until the next move
+  uint8_t ticks_ = 0;   // for the food blink
+  uint8_t foodX_ = 0;
+  uint8_t foodY_ = 0;
+};
+
+/**
+ * Breakout: Left and Right move the paddle on the bottom row, Up launches the ball. Three rows of bricks, three
+ * balls; a cleared wall comes back with a faster ball. The bricks are a TileMap of 4x2 tiles (a 3x1 brick and its
+ * gaps), the ball position is tested against its cells.
+ */
+class BreakoutGame : public Game {
+ public:
+  /* w and h are clamped to 16 - 32 and 8 - 32 */
+  BreakoutGame(uint8_t w, uint8_t h, uint32_t seed);
+
+  void reset() override;
+  bool update(const GameInput& input) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  static const int kPaddleWidth = 6;
+  static const int kBrickRows = 3;
+  static const int kMaxBrickCols = 8;
+
+  void buildWall();
+  void serve();
+  /* Remove the brick at x, y if there is one */
+  bool hitBrick(int16_t x, int16_t y);
+
+  uint8_t width_;
+  uint8_t height_;
+  uint8_t brickCells_[kBrickRows * kMaxBrickCols];
+  TileMap bricks_;
+  uint8_t bricksLeft_ = 0;
+  int16_t paddleX_ = 0;
+  int32_t ballX_ = 0;  // 24.8 fixed point pixels
+  int32_t ballY_ = 0;
+  int16_t speedX_ = 0;  // 8.8 fixed point pixels per tick
+  int16_t speedY_ = 0;
+  int16_t speed_ = 0;   // vertical speed of a served ball
+  uint8_t lives_ = 0;
+  bool launched_ = false;
+  uint8_t ticks_ = 0;
+};
@@ -33,6 +33,7 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #include "Adafruit_GFX.h"
 #include "glcdfont.c"
+#include "bitmapbake.h"
 #ifdef __AVR__
 #include <avr/pgmspace.h>
 #elif defined(ESP8266) || defined(ESP32)
@@ -117,6 +118,9 @@ Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
   wrap = true;
   _cp437 = false;
   gfxFont = NULL;
+  _fontAscent = _fontDescent = 0;
+  unicodeFont = NULL;
+  resetViewport();
 }
 
 /**************************************************************************/
@@ -1137,10 +1141,7 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 
   if (!gfxFont) { // 'Classic' built-in font
 
-    if ((x >= _width) ||              // Clip right
-        (y >= _height) ||             // Clip bottom
-        ((x + 6 * size_x - 1) < 0) || // Clip left
-        ((y + 8 * size_y - 1) < 0))   // Clip top
+    if (isClipped(x, y, 6 * size_x, 8 * size_y)) // Whole cell outside clip
       return;
 
     if (!_cp437 && (c >= 176))
@@ -1194,23 +1195,18 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
       yo16 = yo;
     }
 
-    // Todo: Add character clipping here
-
-    // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
-    // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
-    // has typically been used with the 'classic' font to overwrite old
-    // screen contents with new data.  This ONLY works because the
-    // characters are a uniform size; it's not a sensible thing to do with
-    // proportionally-spaced fonts with glyphs of varying sizes (and that
-    // may overlap).  To replace previously-drawn text when using a custom
-    // font, use the getTextBounds() function to determine the smallest
-    // rectangle encompassing a string, erase the area with fillRect(),
-    // then draw new text.  This WILL infortunately 'blink' the text, but
-    // is unavoidable.  Drawing 'background' pixels will NOT fix this,
-    // only creates a new set of problems.  Have an idea to work around
-    // this (a canvas object type for MCUs that can afford the RAM and
-    // displays supporting setAddrWindow() and pushColors()), but haven't
-    // implemented this yet.
+    // Opaque text fills the glyph's advance box, from the font's highest
+    // ascender to its lowest descender, then draws the glyph over it. Ink
+    // reaching past the advance (kerned or italic glyphs) stays transparent,
+    // so rewriting a string of the same width replaces it without blinking.
+    if (bg != color) {
+      uint8_t xa = pgm_read_byte(&glyph->xAdvance);
+      fillRect(x, y - _fontAscent * size_y, xa * size_x,
+               (_fontAscent + _fontDescent) * size_y, bg);
+    }
+
+    if (isClipped(x + xo * size_x, y + yo * size_y, w * size_x, h * size_y))
+      return; // Whole glyph outside clip
 
     startWrite();
     for (yy = 0; yy < h; yy++) {
@@ -1240,7 +1236,16 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 */
 /**************************************************************************/
 size_t Adafruit_GFX::write(uint8_t c) {
-  if (!gfxFont) { // 'Classic' built-in font
+  if (unicodeFont) { // UTF-8 text through a Unicode font
+    uint32_t codepoint;
+    GFXutf8Decoder::Result result = _utf8.decode(c, &codepoint);
+    if (result == GFXutf8Decoder::AGAIN) { // c ended a cut off sequence
+      writeCodepoint(codepoint);
+      result = _utf8.decode(c, &codepoint);
+    }
+    if (result == GFXutf8Decoder::DONE)
+      writeCodepoint(codepoint);
+  } else if (!gfxFont) { // 'Classic' built-in font
 
     if (c == '\n') {              // Newline?
       cursor_x = 0;               // Reset x to zero,
@@ -1285,6 +1290,219 @@ size_t Adafruit_GFX::write(uint8_t c) {
   return 1;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Print a whole buffer of text in one write transaction. With the
+            classic font the text is cut into runs that end at a newline or
+            where write() would wrap, and each run is clipped and drawn as a
+            unit by drawTextRun(); other fonts go through write() per byte.
+            Cursor movement matches per-character write() exactly.
+    @param  buffer  Characters to print
+    @param  size    Number of bytes in buffer
+    @returns  size
+*/
+/**************************************************************************/
+size_t Adafruit_GFX::write(const char *buffer, size_t size) {
+  startWrite();
+  if (unicodeFont || gfxFont) {
+    for (size_t i = 0; i < size; i++)
+      write((uint8_t)buffer[i]);
+  } else { // 'Classic' built-in font
+    const int16_t cw = textsize_x * 6, ch = textsize_y * 8;
+    size_t i = 0;
+    while (i < size) {
+      char c = buffer[i];
+      if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += ch;
+        i++;
+        continue;
+      }
+      if (c == '\r') {
+        i++;
+        continue;
+      }
+      if (wrap && ((cursor_x + cw) > _width)) { // Off right?
+        cursor_x = 0;
+        cursor_y += ch;
+      }
+      // Characters that still fit on this line (all of them without wrap)
+      size_t n = 1;
+      int32_t right = (int32_t)cursor_x + 2 * cw;
+      while ((i + n < size) && (buffer[i + n] != '\n') &&
+             (buffer[i + n] != '\r') && !(wrap && (right > _width))) {
+        n++;
+        right += cw;
+      }
+      drawTextRun(cursor_x, cursor_y, buffer + i, n);
+      cursor_x += (int16_t)(n * cw);
+      i += n;
+    }
+  }
+  endWrite();
+  return size;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw one decoded code point with the Unicode font and advance
+            the cursor. Code points missing from the font are drawn as
+            U+FFFD, or '?', or skipped if the font has neither.
+    @param  codepoint  The Unicode scalar value
+*/
+/**************************************************************************/
+void Adafruit_GFX::writeCodepoint(uint32_t codepoint) {
+  if (codepoint == '\n') {
+    cursor_x = 0;
+    cursor_y += unicodeFont->yAdvance();
+    return;
+  }
+  if (codepoint == '\r')
+    return;
+
+  GFXunicodeGlyph glyph;
+  if (!unicodeFont->getGlyph(codepoint, &glyph) &&
+      !unicodeFont->getGlyph(0xFFFD, &glyph) &&
+      !unicodeFont->getGlyph('?', &glyph))
+    return;
+  if (wrap && ((cursor_x + glyph.xAdvance) > _width)) {
+    cursor_x = 0;
+    cursor_y += unicodeFont->yAdvance();
+  }
+  drawUnicodeGlyph(cursor_x, cursor_y, &glyph, textcolor, textbgcolor);
+  cursor_x += glyph.xAdvance;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a line of classic font characters from the text settings,
+            without moving the cursor. The run is tested against the clip
+            once and only the characters that overlap it are drawn.
+    @param    x   Top left corner x coordinate of the first character
+    @param    y   Top left corner y coordinate
+    @param    text  Characters, no control codes
+    @param    n   Number of characters
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawTextRun(int16_t x, int16_t y, const char *text,
+                               size_t n) {
+  const int32_t cw = textsize_x * 6, ch = textsize_y * 8;
+  int32_t x0 = (int32_t)x + _originX, y0 = (int32_t)y + _originY;
+  if ((y0 >= _clipY1) || (y0 + ch <= _clipY0) || (x0 >= _clipX1))
+    return;
+  size_t first = (x0 < _clipX0) ? (_clipX0 - x0) / cw : 0;
+  size_t last = (_clipX1 - x0 + cw - 1) / cw; // One past the last visible
+  if (last > n)
+    last = n;
+  for (size_t k = first; k < last; k++)
+    drawChar(x + (int16_t)(k * cw), y, text[k], textcolor, textbgcolor,
+             textsize_x, textsize_y);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a glyph of a Unicode font, unscaled (text size is ignored)
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    glyph  The glyph, from GFXunicodeFont::getGlyph()
+    @param    color 16-bit 5-6-5 Color to draw the glyph with
+    @param    bg 16-bit 5-6-5 Color to fill the glyph cell (bitmap height by
+   xAdvance) with (if same as color, no background)
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawUnicodeGlyph(int16_t x, int16_t y,
+                                    const GFXunicodeGlyph *glyph,
+                                    uint16_t color, uint16_t bg) {
+  if (bg != color)
+    fillRect(x, y, glyph->xAdvance, glyph->height, bg);
+  // The RAM overload: glyph bitmaps may be cached copies, never PROGMEM
+  drawBitmap(x, y, (uint8_t *)glyph->bitmap, glyph->width, glyph->height,
+             color);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw one character of the current font (Unicode, GFXfont or
+            classic, with text size and colors) at a cursor position,
+            without moving the cursor or wrapping
+    @param    x   Cursor x coordinate
+    @param    y   Cursor y coordinate (the baseline for GFXfonts, see
+                  getTextAscent())
+    @param    codepoint  Unicode code point, or the 8-bit character for
+                         the classic font and GFXfonts
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawCodepoint(int16_t x, int16_t y, uint32_t codepoint) {
+  if (unicodeFont) {
+    GFXunicodeGlyph glyph;
+    if (unicodeFont->getGlyph(codepoint, &glyph) ||
+        unicodeFont->getGlyph(0xFFFD, &glyph) ||
+        unicodeFont->getGlyph('?', &glyph))
+      drawUnicodeGlyph(x, y, &glyph, textcolor, textbgcolor);
+  } else if (codepoint <= 0xFF) {
+    if (gfxFont && ((codepoint < pgm_read_word(&gfxFont->first)) ||
+                    (codepoint > pgm_read_word(&gfxFont->last))))
+      return;
+    drawChar(x, y, codepoint, textcolor, textbgcolor, textsize_x, textsize_y);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Cursor advance of one character in the current font, the
+            counterpart of drawCodepoint()
+    @param    codepoint  Unicode code point, or the 8-bit character
+    @returns  Advance in pixels, 0 if the font cannot draw it
+*/
+/**************************************************************************/
+uint8_t Adafruit_GFX::getAdvance(uint32_t codepoint) {
+  if (unicodeFont) {
+    GFXunicodeGlyph glyph;
+    if (unicodeFont->getGlyph(codepoint, &glyph) ||
+        unicodeFont->getGlyph(0xFFFD, &glyph) ||
+        unicodeFont->getGlyph('?', &glyph))
+      return glyph.xAdvance;
+    return 0;
+  }
+  if (codepoint > 0xFF)
+    return 0;
+  if (!gfxFont)
+    return textsize_x * 6;
+  uint16_t first = pgm_read_word(&gfxFont->first);
+  if ((codepoint < first) || (codepoint > pgm_read_word(&gfxFont->last)))
+    return 0;
+  GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, codepoint - first);
+  return (uint8_t)pgm_read_byte(&glyph->xAdvance) * textsize_x;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Newline distance of the current font and text size
+    @returns  Line height in pixels
+*/
+/**************************************************************************/
+uint8_t Adafruit_GFX::getLineHeight(void) const {
+  if (unicodeFont)
+    return unicodeFont->yAdvance();
+  if (gfxFont)
+    return (uint8_t)pgm_read_byte(&gfxFont->yAdvance) * textsize_y;
+  return textsize_y * 8;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Distance from the top of a text line to the cursor y position:
+            the font ascent for GFXfonts (drawn from the baseline), 0 for
+            the classic and Unicode fonts (drawn from the top)
+    @returns  Offset in pixels
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::getTextAscent(void) const {
+  if (gfxFont && !unicodeFont)
+    return _fontAscent * textsize_y;
+  return 0;
+}
+
 /**************************************************************************/
 /*!
     @brief   Set text 'magnification' size. Each increase in s makes 1 pixel
@@ -1327,6 +1545,110 @@ void Adafruit_GFX::setRotation(uint8_t x) {
     _height = WIDTH;
     break;
   }
+  resetViewport();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Enter a sub-region of the display. The origin moves to (x,y) and
+            drawing is clipped to the region (intersected with the current
+            clip). Restore with popViewport().
+    @param  x  Left edge of the region, relative to the current viewport
+    @param  y  Top edge of the region, relative to the current viewport
+    @param  w  Width of the region in pixels
+    @param  h  Height of the region in pixels
+    @returns   false if the viewport stack is full (state left unchanged)
+*/
+/**************************************************************************/
+bool Adafruit_GFX::pushViewport(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (!pushClipRect(x, y, w, h))
+    return false;
+  _originX += x;
+  _originY += y;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Narrow the clip rectangle without moving the origin. Restore
+            with popViewport().
+    @param  x  Left edge of the clip, relative to the current viewport
+    @param  y  Top edge of the clip, relative to the current viewport
+    @param  w  Width of the clip in pixels
+    @param  h  Height of the clip in pixels
+    @returns   false if the viewport stack is full (state left unchanged)
+*/
+/**************************************************************************/
+bool Adafruit_GFX::pushClipRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (_viewportDepth >= GFX_VIEWPORT_DEPTH)
+    return false;
+  Viewport &saved = _viewportStack[_viewportDepth++];
+  saved.originX = _originX;
+  saved.originY = _originY;
+  saved.clipX0 = _clipX0;
+  saved.clipY0 = _clipY0;
+  saved.clipX1 = _clipX1;
+  saved.clipY1 = _clipY1;
+
+  if (!clipRect(x, y, w, h)) { // Nothing visible: leave an empty clip
+    _clipX1 = _clipX0;
+    _clipY1 = _clipY0;
+    return true;
+  }
+  _clipX0 = x;
+  _clipY0 = y;
+  _clipX1 = x + w;
+  _clipY1 = y + h;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Restore the origin and clip saved by the last pushViewport() or
+            pushClipRect(). Does nothing if the stack is empty.
+*/
+/**************************************************************************/
+void Adafruit_GFX::popViewport(void) {
+  if (!_viewportDepth)
+    return;
+  const Viewport &saved = _viewportStack[--_viewportDepth];
+  _originX = saved.originX;
+  _originY = saved.originY;
+  _clipX0 = saved.clipX0;
+  _clipY0 = saved.clipY0;
+  _clipX1 = saved.clipX1;
+  _clipY1 = saved.clipY1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Drop all saved viewports: origin back to (0,0), clip to the
+            full (rotated) display
+*/
+/**************************************************************************/
+void Adafruit_GFX::resetViewport(void) {
+  _viewportDepth = 0;
+  _originX = _originY = 0;
+  _clipX0 = _clipY0 = 0;
+  _clipX1 = _width;
+  _clipY1 = _height;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get the current clip rectangle
+    @param  x  Left edge, relative to the current viewport
+    @param  y  Top edge, relative to the current viewport
+    @param  w  Width in pixels (0 if everything is clipped)
+    @param  h  Height in pixels (0 if everything is clipped)
+*/
+/**************************************************************************/
+void Adafruit_GFX::getClipRect(int16_t *x, int16_t *y, uint16_t *w,
+                               uint16_t *h) const {
+  *x = _clipX0 - _originX;
+  *y = _clipY0 - _originY;
+  *w = _clipX1 - _clipX0;
+  *h = _clipY1 - _clipY0;
 }
 
 /**************************************************************************/
@@ -1348,6 +1670,34 @@ void Adafruit_GFX::setFont(const GFXfont *f) {
     cursor_y -= 6;
   }
   gfxFont = (GFXfont *)f;
+
+  // Vertical extent of the whole font, the height of an opaque text cell
+  _fontAscent = _fontDescent = 0;
+  if (f) {
+    uint16_t n = pgm_read_word(&f->last) - pgm_read_word(&f->first) + 1;
+    for (uint16_t i = 0; i < n; i++) {
+      GFXglyph *glyph = pgm_read_glyph_ptr(f, i);
+      int8_t yo = pgm_read_byte(&glyph->yOffset);
+      int8_t bottom = yo + (int8_t)pgm_read_byte(&glyph->height);
+      if (-yo > _fontAscent)
+        _fontAscent = -yo;
+      if (bottom > _fontDescent)
+        _fontDescent = bottom;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief Set a font for Unicode text. While set, write() and print()
+           decode UTF-8 and draw every code point through it, taking
+           precedence over the classic and GFXfont fonts
+    @param f  The font, or NULL to go back to 8-bit text
+*/
+/**************************************************************************/
+void Adafruit_GFX::setUnicodeFont(GFXunicodeFont *f) {
+  unicodeFont = f;
+  _utf8.reset();
 }
 
 /**************************************************************************/
@@ -1751,6 +2101,230 @@ const uint8_t PROGMEM GFXcanvas1::GFXclrBit[] = {0x7F, 0xBF, 0xDF, 0xEF,
                                                  0xF7, 0xFB, 0xFD, 0xFE};
 #endif
 
+// Packed-row helpers shared by the GFXcanvas1 block operations. Rows are
+// MSB-first (leftmost pixel in bit 7), like the canvas buffer itself.
+
+// Read 8 bits starting at an arbitrary (possibly negative) bit position.
+// Only bytes [0, bytes) of src are touched; bits outside read as 0.
+static inline uint8_t fetchBits(const uint8_t *src, int32_t bytes,
+                                int32_t bit) {
+  int32_t i = bit >> 3; // Floor division, also for negative positions
+  uint8_t sh = bit & 7;
+  uint8_t hi = ((i >= 0) && (i < bytes)) ? src[i] : 0;
+  if (!sh)
+    return hi;
+  uint8_t lo = ((i + 1 >= 0) && (i + 1 < bytes)) ? src[i + 1] : 0;
+  return (hi << sh) | (lo >> (8 - sh));
+}
+
+// Combine source byte s into destination byte d, limited to the bits in m
+static inline uint8_t rasterOp(uint8_t d, uint8_t s, uint8_t m, uint8_t op) {
+  switch (op) {
+  case GFX_ROP_OR:
+    return d | (s & m);
+  case GFX_ROP_AND:
+    return d & (s | ~m);
+  case GFX_ROP_XOR:
+    return d ^ (s & m);
+  case GFX_ROP_ANDNOT:
+    return d & ~(s & m);
+  default:
+    return (d & ~m) | (s & m);
+  }
+}
+
+// Combine w bits of src (starting at bit srcBit, bytes readable) into dst
+// starting at bit dstBit, one destination byte at a time. 'backward' walks
+// right to left, which keeps an overlapping copy within one row correct
+// when the destination lies right of the source. Only the two edge bytes
+// can need source bits outside the block; the whole bytes between them are
+// read without bounds checks (and moved with memmove for an aligned copy).
+static void blitRow(uint8_t *dst, int32_t dstBit, const uint8_t *src,
+                    int32_t bytes, int32_t srcBit, int16_t w, uint8_t op,
+                    bool backward) {
+  int32_t j0 = dstBit >> 3, j1 = (dstBit + w - 1) >> 3;
+  uint8_t m0 = 0xFF >> (dstBit & 7);
+  uint8_t m1 = 0xFF << (7 - ((dstBit + w - 1) & 7));
+  int32_t shift = srcBit - dstBit;
+  if (j0 == j1) {
+    dst[j0] = rasterOp(dst[j0], fetchBits(src, bytes, j0 * 8 + shift),
+                       m0 & m1, op);
+    return;
+  }
+
+  int32_t inner = j1 - j0 - 1, bit = (j0 + 1) * 8 + shift;
+  const uint8_t *s = &src[bit >> 3];
+  uint8_t sh = bit & 7;
+  uint8_t *d = &dst[j0 + 1];
+  if (!backward)
+    dst[j0] = rasterOp(dst[j0], fetchBits(src, bytes, j0 * 8 + shift), m0, op);
+  else
+    dst[j1] = rasterOp(dst[j1], fetchBits(src, bytes, j1 * 8 + shift), m1, op);
+  if (op != GFX_ROP_COPY) {
+    for (int32_t n = 0; n < inner; n++) {
+      int32_t k = backward ? inner - 1 - n : n;
+      uint8_t b = sh ? (uint8_t)((s[k] << sh) | (s[k + 1] >> (8 - sh))) : s[k];
+      d[k] = rasterOp(d[k], b, 0xFF, op);
+    }
+  } else if (!sh) {
+    memmove(d, s, inner);
+  } else if (!backward) {
+    for (int32_t k = 0; k < inner; k++)
+      d[k] = (s[k] << sh) | (s[k + 1] >> (8 - sh));
+  } else {
+    for (int32_t k = inner - 1; k >= 0; k--)
+      d[k] = (s[k] << sh) | (s[k + 1] >> (8 - sh));
+  }
+  if (!backward)
+    dst[j1] = rasterOp(dst[j1], fetchBits(src, bytes, j1 * 8 + shift), m1, op);
+  else
+    dst[j0] = rasterOp(dst[j0], fetchBits(src, bytes, j0 * 8 + shift), m0, op);
+}
+
+// Rectangle version of blitRow() over two packed buffers (raw coordinates).
+// Rows and bytes are walked so that overlapping copies within the same
+// buffer read every source bit before it is overwritten.
+static void blitRect(uint8_t *dst, int16_t dstRowBytes, int16_t x, int16_t y,
+                     const uint8_t *src, int16_t srcRowBytes, int16_t sx,
+                     int16_t sy, int16_t w, int16_t h, uint8_t op) {
+  bool same = (dst == src);
+  bool upward = same && (y > sy);
+  bool backward = same && (y == sy) && (x > sx);
+  for (int16_t n = 0; n < h; n++) {
+    int16_t r = upward ? h - 1 - n : n;
+    blitRow(&dst[(y + r) * dstRowBytes], x, &src[(sy + r) * srcRowBytes],
+            srcRowBytes, sx, w, op, backward);
+  }
+}
+
+// Shift a whole packed row by n bits (0 < n < 8 * bytes); positive n moves
+// pixels right. Vacated bits become 0.
+static void shiftRow(uint8_t *row, int16_t bytes, int16_t n) {
+  int16_t k = (n < 0 ? -n : n) >> 3;
+  uint8_t b = (n < 0 ? -n : n) & 7;
+  if (n < 0) {
+    for (int16_t j = 0; j < bytes - k - 1; j++)
+      row[j] = (row[j + k] << b) | (b ? row[j + k + 1] >> (8 - b) : 0);
+    row[bytes - k - 1] = row[bytes - 1] << b;
+    memset(&row[bytes - k], 0, k);
+  } else {
+    for (int16_t j = bytes - 1; j > k; j--)
+      row[j] = (row[j - k] >> b) | (b ? row[j - k - 1] << (8 - b) : 0);
+    row[k] = row[0] >> b;
+    memset(row, 0, k);
+  }
+}
+
+// Greatest common divisor, for the cycle walk of scrollWrap()
+static int16_t gcd16(int16_t a, int16_t b) {
+  while (b) {
+    int16_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Gray to 1-bit helpers for drawDitheredBitmap(). Gray is 0 (off) to 255 (on).
+
+// 4x4 Bayer matrix: a pixel is lit when gray >= 16 * entry + 8
+static const uint8_t bayer4[4][4] = {
+    {0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+// Matrix offsets (row * 4 + column) of entries 0..15: shifting the matrix
+// by these in turn, frame after frame, shows every pixel each threshold
+// once per 16 frames, spread out as evenly as the matrix itself
+static const uint8_t bayerWalk[16] = {0, 10, 2,  8, 5, 15, 7,  13,
+                                      1, 11, 3, 9, 4, 14, 6, 12};
+
+// Widest bitmap error diffusion takes, its error rows live on the stack
+static const int16_t maxDiffusionWidth = 64;
+
+// Thresholds of one ordered-dither row, halved (thresholds are even, so
+// g >= t is g / 2 >= t / 2) and packed so byte k applies to pixel 4n + k,
+// where pixel 0 is at absolute column ax. The matrix period is 4, so the
+// same word serves every group of 4 pixels in the row.
+static uint32_t ditherThresholds(uint8_t mode, int16_t ax, int16_t ay,
+                                 uint8_t frame) {
+  if (mode == GFX_DITHER_THRESHOLD)
+    return 0x40404040;
+  uint8_t walk = bayerWalk[frame & 15];
+  const uint8_t *m = bayer4[(ay + (walk >> 2)) & 3];
+  uint32_t t = 0;
+  for (uint8_t k = 0; k < 4; k++)
+    t |= (uint32_t)(m[(ax + (walk & 3) + k) & 3] * 8 + 4) << (8 * k);
+  return t;
+}
+
+// Compare 4 gray pixels with their thresholds in one 32-bit word: each byte
+// is g / 2 with bit 7 set, minus t / 2, so no byte borrows from the next
+// and bit 7 stays set exactly where g >= t. The multiply gathers the four
+// bit 7s into a nibble, pixel 0 first.
+static inline uint8_t ditherNibble(const uint8_t *g, uint32_t t) {
+  uint32_t v = g[0] | ((uint32_t)g[1] << 8) | ((uint32_t)g[2] << 16) |
+               ((uint32_t)g[3] << 24);
+  uint32_t d = (((v >> 1) & 0x7F7F7F7F) | 0x80808080) - t;
+  return ((((d >> 7) & 0x01010101) * 0x08040201) >> 24) & 0xF;
+}
+
+// Ordered dither of w gray pixels into MSB-first packed bits, a byte per
+// 8 pixels. Bits past w in the last byte are unspecified.
+static void ditherOrderedRow(uint8_t *out, const uint8_t *gray, int16_t w,
+                             uint32_t t) {
+  int16_t i = 0;
+  for (; i + 8 <= w; i += 8, gray += 8)
+    *out++ = (ditherNibble(gray, t) << 4) | ditherNibble(gray + 4, t);
+  if (i < w) {
+    uint8_t tail[8] = {0};
+    memcpy(tail, gray, w - i);
+    *out = (ditherNibble(tail, t) << 4) | ditherNibble(tail + 4, t);
+  }
+}
+
+// Error diffusion of one row. err[] holds the error rows below, current row
+// first, each with 2 guard entries on either side of the w pixels. The
+// threshold is 128, or jittered by a shifting Bayer pattern for temporal
+// dithering, which also flips the serpentine scan of Floyd-Steinberg.
+static void ditherDiffusedRow(uint8_t *out, const uint8_t *gray, int16_t w,
+                              int16_t *err[3], uint8_t mode, int16_t ax,
+                              int16_t ay, uint8_t frame, bool temporal) {
+  memset(out, 0, (w + 7) / 8);
+  bool fs = (mode == GFX_DITHER_FLOYD_STEINBERG);
+  bool reverse = fs && ((ay + (temporal ? frame : 0)) & 1);
+  int8_t dir = reverse ? -1 : 1;
+  uint8_t walk = bayerWalk[frame & 15];
+  const uint8_t *m = bayer4[(ay + (walk >> 2)) & 3];
+  int16_t *e0 = err[0] + 2, *e1 = err[1] + 2, *e2 = err[2] + 2;
+  for (int16_t n = 0; n < w; n++) {
+    int16_t i = reverse ? w - 1 - n : n;
+    int16_t v = gray[i] + e0[i];
+    int16_t threshold = 128;
+    if (temporal)
+      threshold += (m[(ax + i + (walk & 3)) & 3] - 8) * 4;
+    if (v >= threshold) {
+      out[i >> 3] |= 0x80 >> (i & 7);
+      v -= 255;
+    }
+    if (fs) {
+      // 7/16 ahead, 3/16 behind below, 5/16 below, the rest ahead below
+      int16_t e7 = v * 7 / 16, e3 = v * 3 / 16, e5 = v * 5 / 16;
+      e0[i + dir] += e7;
+      e1[i - dir] += e3;
+      e1[i] += e5;
+      e1[i + dir] += v - e7 - e3 - e5;
+    } else {
+      // Atkinson: 1/8 to each of 6 neighbours, the other 1/4 is dropped
+      int16_t e8 = v / 8;
+      e0[i + 1] += e8;
+      e0[i + 2] += e8;
+      e1[i - 1] += e8;
+      e1[i] += e8;
+      e1[i + 1] += e8;
+      e2[i] += e8;
+    }
+  }
+}
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX 1-bit canvas context for graphics
@@ -1758,11 +2332,33 @@ const uint8_t PROGMEM GFXcanvas1::GFXclrBit[] = {0x7F, 0xBF, 0xDF, 0xEF,
    @param    h   Display height, in pixels
 */
 /**************************************************************************/
-GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), buffer_owned(true) {
   uint16_t bytes = ((w + 7) / 8) * h;
   if ((buffer = (uint8_t *)malloc(bytes))) {
     memset(buffer, 0, bytes);
+  } else {
+    // Out of memory: degrade to an empty canvas, the clip rectangle then
+    // rejects every primitive and none of them has to test for a buffer
+    WIDTH = HEIGHT = _width = _height = 0;
+    resetViewport();
   }
+  bindRotation();
+}
+
+/**************************************************************************/
+/*!
+   @brief    Instantiate a GFX 1-bit canvas on caller-provided storage, which
+             is not freed by the canvas and must outlive it
+   @param    w        Display width, in pixels
+   @param    h        Display height, in pixels
+   @param    storage  At least ((w + 7) / 8) * h bytes, cleared here
+*/
+/**************************************************************************/
+GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h, uint8_t *storage)
+    : Adafruit_GFX(w, h), buffer(storage), buffer_owned(false) {
+  memset(buffer, 0, ((w + 7) / 8) * h);
+  bindRotation();
 }
 
 /**************************************************************************/
@@ -1771,10 +2367,76 @@ GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
 */
 /**************************************************************************/
 GFXcanvas1::~GFXcanvas1(void) {
-  if (buffer)
+  if (buffer_owned)
     free(buffer);
 }
 
+// Map absolute, unrotated-canvas coordinates for rotation R (resolved at
+// compile time, one copy per rotation)
+template <uint8_t R>
+static inline void rotatePoint(int16_t &x, int16_t &y, int16_t W, int16_t H) {
+  int16_t t;
+  if (R == 1) {
+    t = x;
+    x = W - 1 - y;
+    y = t;
+  } else if (R == 2) {
+    x = W - 1 - x;
+    y = H - 1 - y;
+  } else if (R == 3) {
+    t = x;
+    x = y;
+    y = H - 1 - t;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set rotation and bind the matching specialized pixel and line
+            paths, so no per-call rotation switch remains
+    @param  r  0 thru 3 corresponding to 4 cardinal rotations
+*/
+/**************************************************************************/
+void GFXcanvas1::setRotation(uint8_t r) {
+  Adafruit_GFX::setRotation(r);
+  bindRotation();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Point the pixel/line function pointers at the code for the
+            current rotation
+*/
+/**************************************************************************/
+void GFXcanvas1::bindRotation(void) {
+  switch (rotation) {
+  case 0:
+    _drawPixelFn = &GFXcanvas1::drawPixelRot<0>;
+    _getPixelFn = &GFXcanvas1::getPixelRot<0>;
+    _drawFastVLineFn = &GFXcanvas1::drawFastVLineRot<0>;
+    _drawFastHLineFn = &GFXcanvas1::drawFastHLineRot<0>;
+    break;
+  case 1:
+    _drawPixelFn = &GFXcanvas1::drawPixelRot<1>;
+    _getPixelFn = &GFXcanvas1::getPixelRot<1>;
+    _drawFastVLineFn = &GFXcanvas1::drawFastVLineRot<1>;
+    _drawFastHLineFn = &GFXcanvas1::drawFastHLineRot<1>;
+    break;
+  case 2:
+    _drawPixelFn = &GFXcanvas1::drawPixelRot<2>;
+    _getPixelFn = &GFXcanvas1::getPixelRot<2>;
+    _drawFastVLineFn = &GFXcanvas1::drawFastVLineRot<2>;
+    _drawFastHLineFn = &GFXcanvas1::drawFastHLineRot<2>;
+    break;
+  default:
+    _drawPixelFn = &GFXcanvas1::drawPixelRot<3>;
+    _getPixelFn = &GFXcanvas1::getPixelRot<3>;
+    _drawFastVLineFn = &GFXcanvas1::drawFastVLineRot<3>;
+    _drawFastHLineFn = &GFXcanvas1::drawFastHLineRot<3>;
+    break;
+  }
+}
+
 /**************************************************************************/
 /*!
     @brief  Draw a pixel to the canvas framebuffer
@@ -1784,41 +2446,34 @@ GFXcanvas1::~GFXcanvas1(void) {
 */
 /**************************************************************************/
 void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
-  if (buffer) {
-    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
-      return;
+  if (clipPixel(x, y))
+    (this->*_drawPixelFn)(x, y, color);
+}
 
-    int16_t t;
-    switch (rotation) {
-    case 1:
-      t = x;
-      x = WIDTH - 1 - y;
-      y = t;
-      break;
-    case 2:
-      x = WIDTH - 1 - x;
-      y = HEIGHT - 1 - y;
-      break;
-    case 3:
-      t = x;
-      x = y;
-      y = HEIGHT - 1 - t;
-      break;
-    }
+/**************************************************************************/
+/*!
+    @brief  drawPixel() for one rotation
+    @param  x     Absolute x coordinate, already clipped
+    @param  y     Absolute y coordinate, already clipped
+    @param  color Binary (on or off) color to fill with
+*/
+/**************************************************************************/
+template <uint8_t R>
+void GFXcanvas1::drawPixelRot(int16_t x, int16_t y, uint16_t color) {
+  rotatePoint<R>(x, y, WIDTH, HEIGHT);
 
-    uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
+  uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
 #ifdef __AVR__
-    if (color)
-      *ptr |= pgm_read_byte(&GFXsetBit[x & 7]);
-    else
-      *ptr &= pgm_read_byte(&GFXclrBit[x & 7]);
+  if (color)
+    *ptr |= pgm_read_byte(&GFXsetBit[x & 7]);
+  else
+    *ptr &= pgm_read_byte(&GFXclrBit[x & 7]);
 #else
-    if (color)
-      *ptr |= 0x80 >> (x & 7);
-    else
-      *ptr &= ~(0x80 >> (x & 7));
+  if (color)
+    *ptr |= 0x80 >> (x & 7);
+  else
+    *ptr &= ~(0x80 >> (x & 7));
 #endif
-  }
 }
 
 /**********************************************************************/
@@ -1831,23 +2486,19 @@ void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
 */
 /**********************************************************************/
 bool GFXcanvas1::getPixel(int16_t x, int16_t y) const {
-  int16_t t;
-  switch (rotation) {
-  case 1:
-    t = x;
-    x = WIDTH - 1 - y;
-    y = t;
-    break;
-  case 2:
-    x = WIDTH - 1 - x;
-    y = HEIGHT - 1 - y;
-    break;
-  case 3:
-    t = x;
-    x = y;
-    y = HEIGHT - 1 - t;
-    break;
-  }
+  return (this->*_getPixelFn)(x + _originX, y + _originY);
+}
+
+/**********************************************************************/
+/*!
+        @brief    getPixel() for one rotation
+        @param    x   Absolute x coordinate
+        @param    y   Absolute y coordinate
+        @returns  The desired pixel's binary color value
+*/
+/**********************************************************************/
+template <uint8_t R> bool GFXcanvas1::getPixelRot(int16_t x, int16_t y) const {
+  rotatePoint<R>(x, y, WIDTH, HEIGHT);
   return getRawPixel(x, y);
 }
 
@@ -1902,44 +2553,41 @@ void GFXcanvas1::fillScreen(uint16_t color) {
 /**************************************************************************/
 void GFXcanvas1::drawFastVLine(int16_t x, int16_t y, int16_t h,
                                uint16_t color) {
-
-  if (h < 0) { // Convert negative heights to positive equivalent
-    h *= -1;
-    y -= h - 1;
-    if (y < 0) {
-      h += y;
-      y = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((x < 0) || (x >= width()) || (y >= height()) || ((y + h - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t w = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
+  (this->*_drawFastVLineFn)(x, y, h, color);
+}
 
-  if (y < 0) { // Clip top
-    h += y;
-    y = 0;
-  }
-  if (y + h > height()) { // Clip bottom
-    h = height() - y;
-  }
-
-  if (getRotation() == 0) {
-    drawFastRawVLine(x, y, h, color);
-  } else if (getRotation() == 1) {
+/**************************************************************************/
+/*!
+   @brief  drawFastVLine() for one rotation
+   @param  x      Absolute line horizontal start point, already clipped
+   @param  y      Absolute line vertical start point, already clipped
+   @param  h      Length of vertical line to be drawn, including first point
+   @param  color  Color to fill with
+*/
+/**************************************************************************/
+template <uint8_t R>
+void GFXcanvas1::drawFastVLineRot(int16_t x, int16_t y, int16_t h,
+                                  uint16_t color) {
+  if (R == 0) {
+    drawFastRawVLine(x, y, h, color);
+  } else if (R == 1) {
     int16_t t = x;
     x = WIDTH - 1 - y;
     y = t;
     x -= h - 1;
     drawFastRawHLine(x, y, h, color);
-  } else if (getRotation() == 2) {
+  } else if (R == 2) {
     x = WIDTH - 1 - x;
     y = HEIGHT - 1 - y;
 
     y -= h - 1;
     drawFastRawVLine(x, y, h, color);
-  } else if (getRotation() == 3) {
+  } else {
     int16_t t = x;
     x = y;
     y = HEIGHT - 1 - t;
@@ -1958,42 +2606,40 @@ void GFXcanvas1::drawFastVLine(int16_t x, int16_t y, int16_t h,
 /**************************************************************************/
 void GFXcanvas1::drawFastHLine(int16_t x, int16_t y, int16_t w,
                                uint16_t color) {
-  if (w < 0) { // Convert negative widths to positive equivalent
-    w *= -1;
-    x -= w - 1;
-    if (x < 0) {
-      w += x;
-      x = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((y < 0) || (y >= height()) || (x >= width()) || ((x + w - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t h = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
+  (this->*_drawFastHLineFn)(x, y, w, color);
+}
 
-  if (x < 0) { // Clip left
-    w += x;
-    x = 0;
-  }
-  if (x + w >= width()) { // Clip right
-    w = width() - x;
-  }
-
-  if (getRotation() == 0) {
+/**************************************************************************/
+/*!
+   @brief  drawFastHLine() for one rotation
+   @param  x      Absolute line horizontal start point, already clipped
+   @param  y      Absolute line vertical start point, already clipped
+   @param  w      Length of horizontal line to be drawn, including first point
+   @param  color  Color to fill with
+*/
+/**************************************************************************/
+template <uint8_t R>
+void GFXcanvas1::drawFastHLineRot(int16_t x, int16_t y, int16_t w,
+                                  uint16_t color) {
+  if (R == 0) {
     drawFastRawHLine(x, y, w, color);
-  } else if (getRotation() == 1) {
+  } else if (R == 1) {
     int16_t t = x;
     x = WIDTH - 1 - y;
     y = t;
     drawFastRawVLine(x, y, w, color);
-  } else if (getRotation() == 2) {
+  } else if (R == 2) {
     x = WIDTH - 1 - x;
     y = HEIGHT - 1 - y;
 
     x -= w - 1;
     drawFastRawHLine(x, y, w, color);
-  } else if (getRotation() == 3) {
+  } else {
     int16_t t = x;
     x = y;
     y = HEIGHT - 1 - t;
@@ -2002,6 +2648,1143 @@ void GFXcanvas1::drawFastHLine(int16_t x, int16_t y, int16_t w,
   }
 }
 
+/**************************************************************************/
+/*!
+   @brief  Speed optimized rectangle fill: clipped once, then one raw span
+           per buffer row
+   @param  x      Top left corner x coordinate
+   @param  y      Top left corner y coordinate
+   @param  w      Width in pixels
+   @param  h      Height in pixels
+   @param  color  Binary (on or off) color to fill with
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                          uint16_t color) {
+  // Same extents as the generic column-by-column fill: nothing for w <= 0,
+  // a negative h extends upwards like drawFastVLine()
+  if ((w <= 0) || !clipRect(x, y, w, h)) {
+    return;
+  }
+
+  rawRect(x, y, w, h);
+  for (int16_t i = 0; i < h; i++) {
+    drawFastRawHLine(x, y + i, w, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Rectangle fill in raw buffer coordinates (no rotation, viewport or
+           clipping), for code that keeps its own buffer-space areas
+   @param  x      Top left corner x coordinate, inside the buffer
+   @param  y      Top left corner y coordinate, inside the buffer
+   @param  w      Width in pixels, ending inside the buffer
+   @param  h      Height in pixels, ending inside the buffer
+   @param  color  Binary (on or off) color to fill with
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color) {
+  if ((w <= 0) || (h <= 0)) {
+    return;
+  }
+  for (int16_t i = 0; i < h; i++) {
+    drawFastRawHLine(x, y + i, w, color);
+  }
+}
+
+// The classic font transposed to canvas rows at compile time: row j of
+// glyph c holds glyph column i in bit (7 - i), so a text row is one shifted
+// byte
+static constexpr GFXrowFont<256, 8> classicRows =
+    gfxBakeColumnFont<256, 5, 8>(font);
+
+static const uint8_t *classicGlyphRows(unsigned char c) {
+  return classicRows.rows[c];
+}
+
+// Bit-stretch tables for scaled classic text: entry b of table s - 2 is the
+// 6-bit cell row b (glyph columns plus spacing, leftmost pixel in bit 5)
+// with every bit repeated s times, right-aligned
+struct ScaledRows {
+  uint32_t bits[3][64];
+};
+
+static constexpr ScaledRows makeScaledRows() {
+  ScaledRows t{};
+  for (int s = 2; s <= 4; s++) {
+    for (int b = 0; b < 64; b++) {
+      for (int i = 0; i < 6; i++) {
+        if (b & (0x20 >> i))
+          t.bits[s - 2][b] |= (((uint32_t)1 << s) - 1) << (s * (5 - i));
+      }
+    }
+  }
+  return t;
+}
+
+static constexpr ScaledRows scaledRows = makeScaledRows();
+
+/**************************************************************************/
+/*!
+   @brief   Draw a single character. Text on an unrotated canvas is clipped
+            once per glyph and merged into the buffer one glyph row at a
+            time (classic font scaled up to 9x, GFXfont unscaled); anything
+            else goes through Adafruit_GFX.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color Binary (on or off) color to draw character with
+    @param    bg Binary (on or off) color to fill background with (if same
+   as color, no background)
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
+*/
+/**************************************************************************/
+void GFXcanvas1::drawChar(int16_t x, int16_t y, unsigned char c,
+                          uint16_t color, uint16_t bg, uint8_t size_x,
+                          uint8_t size_y) {
+  if (rotation || (gfxFont && ((size_x != 1) || (size_y != 1))) ||
+      (size_x > 9)) {
+    Adafruit_GFX::drawChar(x, y, c, color, bg, size_x, size_y);
+    return;
+  }
+  if (gfxFont) {
+    drawFontChar(x, y, c, color, bg);
+    return;
+  }
+  if ((size_x != 1) || (size_y != 1)) {
+    drawScaledChar(x, y, c, color, bg, size_x, size_y);
+    return;
+  }
+
+  bool opaque = (bg != color);
+  int16_t gx = x + _originX, gy = y + _originY; // Glyph origin, absolute
+  int16_t w = opaque ? 6 : 5, h = 8; // Opaque also fills the spacing column
+  if (!clipRect(x, y, w, h))
+    return;
+
+  if (!_cp437 && (c >= 176))
+    c++; // Handle 'classic' charset behavior
+  const uint8_t *rows = classicGlyphRows(c);
+
+  // The visible part of a glyph row (at most 6 bits) spans one or two
+  // buffer bytes: work on it as a 16-bit window starting at byte x / 8
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  uint8_t skip = x - gx, shift = x & 7;
+  uint16_t mask = (uint16_t)(0xFF00 << (8 - w)) >> shift;
+  bool wide = (shift + w > 8);
+  for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+    uint8_t bits = rows[y - gy + j] << skip;
+    uint16_t fg = ((uint16_t)bits << 8 >> shift) & mask;
+    // Glyph pixels take color; in opaque mode the rest of the cell takes bg
+    uint16_t on = (color ? fg : 0) | ((opaque && bg) ? (mask & ~fg) : 0);
+    uint16_t off = (opaque ? mask : fg) & ~on;
+    dst[0] = (dst[0] & ~(off >> 8)) | (on >> 8);
+    if (wide)
+      dst[1] = (dst[1] & ~off) | (on & 0xFF);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Classic font character scaled by size_x / size_y: each glyph row
+            is stretched into a 64-bit window (by lookup table up to 4x, bit
+            by bit above), which is merged into size_y buffer rows
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color Binary (on or off) color to draw character with
+    @param    bg Binary (on or off) color to fill background with (if same
+   as color, no background)
+    @param    size_x  Font magnification level in X-axis, 1 to 9
+    @param    size_y  Font magnification level in Y-axis
+*/
+/**************************************************************************/
+void GFXcanvas1::drawScaledChar(int16_t x, int16_t y, unsigned char c,
+                                uint16_t color, uint16_t bg, uint8_t size_x,
+                                uint8_t size_y) {
+  bool opaque = (bg != color);
+  int16_t gx = x + _originX, gy = y + _originY; // Cell origin, absolute
+  int16_t cellW = 6 * size_x;
+  int16_t w = opaque ? cellW : 5 * size_x, h = 8 * size_y;
+  if (!clipRect(x, y, w, h))
+    return;
+
+  if (!_cp437 && (c >= 176))
+    c++; // Handle 'classic' charset behavior
+  const uint8_t *rows = classicGlyphRows(c);
+
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  uint8_t skip = x - gx, shift = x & 7;
+  uint64_t mask = (~(uint64_t)0 << (64 - w)) >> shift;
+  uint8_t bytes = (shift + w + 7) >> 3;
+  int16_t row = -1;
+  uint64_t on = 0, off = 0;
+  for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+    int16_t r = (y - gy + j) / size_y;
+    if (r != row) { // Next glyph row: stretch it once for its size_y lines
+      row = r;
+      uint8_t bits = rows[r] >> 2;
+      uint64_t wide = 0;
+      if (size_x == 1) {
+        wide = bits;
+      } else if (size_x <= 4) {
+        wide = scaledRows.bits[size_x - 2][bits];
+      } else {
+        for (int8_t i = 0; i < 6; i++) {
+          if (bits & (0x20 >> i))
+            wide |= (((uint64_t)1 << size_x) - 1) << (size_x * (5 - i));
+        }
+      }
+      uint64_t fg = ((wide << (64 - cellW)) << skip >> shift) & mask;
+      on = (color ? fg : 0) | ((opaque && bg) ? (mask & ~fg) : 0);
+      off = (opaque ? mask : fg) & ~on;
+    }
+    for (uint8_t k = 0; k < bytes; k++) {
+      uint8_t o = on >> (56 - 8 * k), f = off >> (56 - 8 * k);
+      dst[k] = (dst[k] & ~f) | o;
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Unscaled classic font run for write(): the clip is applied to
+            the whole run once, then every visible character is merged with
+            the same 16-bit window as drawChar(), without the per-character
+            virtual call and bounds setup
+    @param    x   Top left corner x coordinate of the first character
+    @param    y   Top left corner y coordinate
+    @param    text  Characters, no control codes
+    @param    n   Number of characters
+*/
+/**************************************************************************/
+void GFXcanvas1::drawTextRun(int16_t x, int16_t y, const char *text,
+                             size_t n) {
+  if ((textsize_x != 1) || (textsize_y != 1) || rotation) {
+    Adafruit_GFX::drawTextRun(x, y, text, n);
+    return;
+  }
+
+  uint16_t color = textcolor, bg = textbgcolor;
+  bool opaque = (bg != color);
+  int32_t gx = (int32_t)x + _originX, gy = (int32_t)y + _originY;
+  if ((gx >= _clipX1) || (gy >= _clipY1) || (gy + 8 <= _clipY0))
+    return;
+  size_t first = (gx < _clipX0) ? (_clipX0 - gx) / 6 : 0;
+  size_t last = (_clipX1 - gx + 5) / 6; // One past the last visible
+  if (last > n)
+    last = n;
+  int16_t top = (gy < _clipY0) ? _clipY0 : gy;
+  int16_t h = ((gy + 8 > _clipY1) ? _clipY1 : gy + 8) - top;
+  uint8_t skipRows = top - gy;
+
+  int16_t rowBytes = getRowBytes();
+  uint8_t *row = &buffer[top * rowBytes];
+  for (size_t k = first; k < last; k++) {
+    unsigned char c = text[k];
+    if (!_cp437 && (c >= 176))
+      c++; // Handle 'classic' charset behavior
+    const uint8_t *rows = classicGlyphRows(c) + skipRows;
+
+    // Cell columns inside the clip; opaque cells include the spacing column
+    int32_t cx = gx + (int32_t)k * 6;
+    int32_t left = (cx < _clipX0) ? _clipX0 : cx;
+    int32_t right = cx + (opaque ? 6 : 5);
+    if (right > _clipX1)
+      right = _clipX1;
+    if (left >= right)
+      continue;
+    uint8_t skip = left - cx, shift = left & 7, w = right - left;
+    uint16_t mask = (uint16_t)(0xFF00 << (8 - w)) >> shift;
+    bool wide = (shift + w > 8);
+    uint8_t *dst = row + (left >> 3);
+    for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+      uint8_t bits = rows[j] << skip;
+      uint16_t fg = ((uint16_t)bits << 8 >> shift) & mask;
+      uint16_t on = (color ? fg : 0) | ((opaque && bg) ? (mask & ~fg) : 0);
+      uint16_t off = (opaque ? mask : fg) & ~on;
+      dst[0] = (dst[0] & ~(off >> 8)) | (on >> 8);
+      if (wide)
+        dst[1] = (dst[1] & ~off) | (on & 0xFF);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Unscaled GFXfont glyph for drawChar(): each bitmap row is taken
+            straight from the packed glyph bit stream, shifted to the
+            destination column and merged a byte at a time
+    @param    x   Cursor x coordinate (glyph origin on the baseline)
+    @param    y   Cursor y coordinate (baseline)
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color Binary (on or off) color to draw character with
+    @param    bg Binary (on or off) color to fill the advance box with (if
+   same as color, no background)
+*/
+/**************************************************************************/
+void GFXcanvas1::drawFontChar(int16_t x, int16_t y, unsigned char c,
+                              uint16_t color, uint16_t bg) {
+#ifdef __AVR__
+  // Glyph bitmaps live in flash, read through pgm_read_byte() only
+  Adafruit_GFX::drawChar(x, y, c, color, bg, 1, 1);
+#else
+  c -= (uint8_t)pgm_read_byte(&gfxFont->first);
+  GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c);
+  const uint8_t *bitmap = pgm_read_bitmap_ptr(gfxFont);
+
+  uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t w = pgm_read_byte(&glyph->width), h = pgm_read_byte(&glyph->height);
+  int8_t xo = pgm_read_byte(&glyph->xOffset),
+         yo = pgm_read_byte(&glyph->yOffset);
+
+  if (bg != color) // Advance box, as in Adafruit_GFX::drawChar()
+    fillRect(x, y - _fontAscent, pgm_read_byte(&glyph->xAdvance),
+             _fontAscent + _fontDescent, bg);
+
+  int16_t gx = x + xo + _originX, gy = y + yo + _originY; // Absolute
+  int16_t cx = x + xo, cy = y + yo, cw = w, ch = h;
+  if (!w || !h || !clipRect(cx, cy, cw, ch))
+    return;
+
+  // Glyph rows are not byte aligned: row r starts at bit r * w
+  const uint8_t *src = &bitmap[bo];
+  int32_t bytes = ((int32_t)w * h + 7) / 8;
+  int32_t bit = (int32_t)(cy - gy) * w + (cx - gx);
+  int16_t rowBytes = getRowBytes();
+  uint8_t op = color ? GFX_ROP_OR : GFX_ROP_ANDNOT;
+  for (int16_t j = 0; j < ch; j++, bit += w) {
+    blitRow(&buffer[(cy + j) * rowBytes], cx, src, bytes, bit, cw, op, false);
+  }
+#endif
+}
+
+/**************************************************************************/
+/*!
+   @brief   Print a decimal number at the text cursor in a digit font,
+            straight from its two-digit row table (no string formatting).
+            Uses the text colors like print(): opaque if the background
+            color differs. The cursor advances by one xAdvance per digit.
+    @param    value   The number to draw
+    @param    digits  Field width: zero padded, and only the lowest 'digits'
+                      digits are shown; 0 draws just the digits of value
+    @param    font    Digit font, e.g. &Digits5x7Bold
+*/
+/**************************************************************************/
+void GFXcanvas1::drawNumber(uint32_t value, uint8_t digits,
+                            const GFXdigitFont *font) {
+  uint8_t d[10]; // Decimal digits, most significant first
+  uint8_t n = digits;
+  if (!n) {
+    for (uint32_t v = value; v >= 10; v /= 10)
+      n++;
+    n++;
+  }
+  if (n > 10)
+    n = 10;
+  for (int8_t i = n - 1; i >= 0; i--, value /= 10)
+    d[i] = value % 10;
+
+  uint8_t adv = font->xAdvance, h = font->height;
+  uint8_t i = 0;
+  if (n & 1) { // Odd count: the leading digit alone, then pairs
+    uint16_t rows[8];
+    for (uint8_t r = 0; r < 8; r++)
+      rows[r] = font->glyph[d[0]][r] << 8;
+    drawDigitCell(cursor_x, cursor_y, rows, adv, h);
+    cursor_x += adv;
+    i = 1;
+  }
+  for (; i < n; i += 2) {
+    drawDigitCell(cursor_x, cursor_y, font->pair[d[i] * 10 + d[i + 1]],
+                  2 * adv, h);
+    cursor_x += 2 * adv;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw one cell of drawNumber(): up to 16 columns per row, MSB
+            first, clipped once and merged as one shifted word per row
+    @param    x     Top left corner x coordinate
+    @param    y     Top left corner y coordinate
+    @param    rows  h row words
+    @param    w     Cell width including the spacing column(s)
+    @param    h     Cell height
+*/
+/**************************************************************************/
+void GFXcanvas1::drawDigitCell(int16_t x, int16_t y, const uint16_t *rows,
+                               int16_t w, int16_t h) {
+  bool opaque = (textbgcolor != textcolor);
+  if (rotation) {
+    for (int16_t j = 0; j < h; j++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (rows[j] & (0x8000 >> i))
+          drawPixel(x + i, y + j, textcolor);
+        else if (opaque)
+          drawPixel(x + i, y + j, textbgcolor);
+      }
+    }
+    return;
+  }
+
+  int16_t gx = x + _originX, gy = y + _originY; // Cell origin, absolute
+  if (!clipRect(x, y, w, h))
+    return;
+
+  // The visible part of a row (at most 16 bits) spans up to three buffer
+  // bytes: work on it as a 32-bit window starting at byte x / 8
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  uint8_t skip = x - gx, shift = x & 7;
+  uint32_t mask = ((uint32_t)0xFFFFFFFF << (32 - w)) >> shift;
+  uint8_t bytes = (shift + w + 7) >> 3;
+  for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+    uint16_t bits = rows[y - gy + j] << skip;
+    uint32_t fg = ((uint32_t)bits << 16 >> shift) & mask;
+    // Digit pixels take the text color; if opaque the rest of the cell bg
+    uint32_t on = (textcolor ? fg : 0) |
+                  ((opaque && textbgcolor) ? (mask & ~fg) : 0);
+    uint32_t off = (opaque ? mask : fg) & ~on;
+    for (uint8_t k = 0; k < bytes; k++) {
+      uint8_t sh = 24 - 8 * k;
+      dst[k] = (dst[k] & ~(uint8_t)(off >> sh)) | (uint8_t)(on >> sh);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a glyph of a Unicode font with drawBitmap()'s row blit
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    glyph  The glyph, from GFXunicodeFont::getGlyph()
+    @param    color Binary (on or off) color to draw the glyph with
+    @param    bg Binary (on or off) color to fill the glyph cell with (if
+   same as color, no background)
+*/
+/**************************************************************************/
+void GFXcanvas1::drawUnicodeGlyph(int16_t x, int16_t y,
+                                  const GFXunicodeGlyph *glyph,
+                                  uint16_t color, uint16_t bg) {
+  if (rotation) {
+    Adafruit_GFX::drawUnicodeGlyph(x, y, glyph, color, bg);
+    return;
+  }
+  if (bg != color)
+    fillRect(x, y, glyph->xAdvance, glyph->height, bg);
+  drawRowBitmap(x, y, glyph->bitmap, glyph->width, glyph->height, color);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a 1-bit image stored in the canvas row format (MSB-first,
+            rows padded to whole bytes), e.g. baked with bitmapbake.h.
+            Only set bits are drawn.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                            int16_t w, int16_t h, uint16_t color) {
+#ifdef __AVR__
+  // PROGMEM data, read through pgm_read_byte() only
+  Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+#else
+  drawRowBitmap(x, y, bitmap, w, h, color);
+#endif
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a RAM-resident 1-bit image, see the const overload
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  byte array with monochrome bitmap
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
+                            int16_t h, uint16_t color) {
+  drawRowBitmap(x, y, bitmap, w, h, color);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a 1-bit image of up to 32 pixel wide rows packed in words
+            (leftmost pixel in bit 31, see gfxBakeWords()). Each row is one
+            shifted 64-bit window merged into the buffer.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    rows   One word per row
+    @param    w   Width of bitmap in pixels (at most 32)
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawBitmap(int16_t x, int16_t y, const uint32_t rows[],
+                            int16_t w, int16_t h, uint16_t color) {
+  if (w > 32)
+    w = 32;
+  int16_t gx = x + _originX, gy = y + _originY; // Bitmap origin, absolute
+  if (rotation) {
+    startWrite();
+    for (int16_t j = 0; j < h; j++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (rows[j] & (0x80000000UL >> i))
+          writePixel(x + i, y + j, color);
+      }
+    }
+    endWrite();
+    return;
+  }
+  if ((w <= 0) || (h <= 0) || !clipRect(x, y, w, h))
+    return;
+
+  rows += y - gy;
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  uint8_t skip = x - gx, shift = x & 7;
+  uint64_t mask = ((uint64_t)((uint32_t)0xFFFFFFFF << (32 - w)) << 32) >> shift;
+  uint8_t bytes = (shift + w + 7) >> 3;
+  for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+    uint64_t bits = ((uint64_t)(rows[j] << skip) << 32 >> shift) & mask;
+    for (uint8_t k = 0; k < bytes; k++) {
+      uint8_t b = bits >> (56 - 8 * k);
+      dst[k] = color ? (dst[k] | b) : (dst[k] & ~b);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a 1-bit image of up to 32 pixel wide rows packed in words
+            (leftmost pixel in bit 31) with a background color: every pixel
+            of the w x h area is written, each row byte is stored whole.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    rows   One word per row
+    @param    w   Width of bitmap in pixels (at most 32)
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw set pixels with
+    @param    bg Binary (on or off) color to draw clear pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawBitmap(int16_t x, int16_t y, const uint32_t rows[],
+                            int16_t w, int16_t h, uint16_t color,
+                            uint16_t bg) {
+  if (w > 32)
+    w = 32;
+  int16_t gx = x + _originX, gy = y + _originY; // Bitmap origin, absolute
+  if (rotation) {
+    startWrite();
+    for (int16_t j = 0; j < h; j++) {
+      for (int16_t i = 0; i < w; i++) {
+        writePixel(x + i, y + j,
+                   (rows[j] & (0x80000000UL >> i)) ? color : bg);
+      }
+    }
+    endWrite();
+    return;
+  }
+  if ((w <= 0) || (h <= 0) || !clipRect(x, y, w, h))
+    return;
+
+  rows += y - gy;
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  uint8_t skip = x - gx, shift = x & 7;
+  uint64_t mask = ((uint64_t)((uint32_t)0xFFFFFFFF << (32 - w)) << 32) >> shift;
+  uint8_t bytes = (shift + w + 7) >> 3;
+  for (int16_t j = 0; j < h; j++, dst += rowBytes) {
+    uint64_t bits = ((uint64_t)(rows[j] << skip) << 32 >> shift) & mask;
+    // Set pixels take color, clear ones bg, those outside the mask stay
+    uint64_t on = (color ? bits : 0) | (bg ? mask & ~bits : 0);
+    for (uint8_t k = 0; k < bytes; k++) {
+      uint8_t m = mask >> (56 - 8 * k);
+      dst[k] = (dst[k] & ~m) | (uint8_t)(on >> (56 - 8 * k));
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a 1-bit image pre-shifted for all x % 8 phases (see
+            gfxBakeShifted()): the copy matching the destination x is
+            merged a whole byte at a time, no bit shifting at draw time
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  8 copies of h rows of (w + 7) / 8 + 1 bytes, copy p
+   shifted right by p pixels
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawShiftedBitmap(int16_t x, int16_t y,
+                                   const uint8_t bitmap[], int16_t w,
+                                   int16_t h, uint16_t color) {
+  int16_t srcRowBytes = (w + 7) / 8 + 1;
+  if (rotation) { // Phase 0 is the plain bitmap with a wider stride
+    startWrite();
+    for (int16_t j = 0; j < h; j++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (bitmap[j * srcRowBytes + i / 8] & (0x80 >> (i & 7)))
+          writePixel(x + i, y + j, color);
+      }
+    }
+    endWrite();
+    return;
+  }
+
+  int16_t gx = x + _originX, gy = y + _originY; // Bitmap origin, absolute
+  int16_t copyRows = h;
+  if ((w <= 0) || (h <= 0) || !clipRect(x, y, w, h))
+    return;
+
+  // Source bit (x - gx) + phase has the same x % 8 as destination bit x:
+  // rows are merged a whole byte at a time, no shifting
+  uint8_t phase = gx & 7;
+  const uint8_t *src = &bitmap[(phase * copyRows + (y - gy)) * srcRowBytes +
+                               ((x - gx + phase) >> 3)];
+  int16_t rowBytes = getRowBytes();
+  uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+  int16_t bytes = ((x + w - 1) >> 3) - (x >> 3) + 1;
+  uint8_t m0 = 0xFF >> (x & 7), m1 = 0xFF << (7 - ((x + w - 1) & 7));
+  for (int16_t j = 0; j < h; j++, src += srcRowBytes, dst += rowBytes) {
+    for (int16_t k = 0; k < bytes; k++) {
+      uint8_t b = src[k];
+      if (k == 0)
+        b &= m0;
+      if (k == bytes - 1)
+        b &= m1;
+      dst[k] = color ? (dst[k] | b) : (dst[k] & ~b);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw a 1-bit image from PackBits-encoded rows (see gfxBakeRLE()):
+            each row is expanded into a small buffer and merged with the
+            row blit. Rows above the clip are skipped without expanding.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    data  Encoded rows
+    @param    w   Width of bitmap in pixels (at most 256)
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawRLEBitmap(int16_t x, int16_t y, const uint8_t data[],
+                               int16_t w, int16_t h, uint16_t color) {
+  uint8_t row[32];
+  int16_t srcRowBytes = (w + 7) / 8;
+  if ((w <= 0) || (h <= 0) || (srcRowBytes > (int16_t)sizeof(row)))
+    return;
+
+  int16_t gx = x + _originX, gy = y + _originY; // Bitmap origin, absolute
+  int16_t cx = x, cy = y, cw = w, ch = h;
+  if (!clipRect(cx, cy, cw, ch))
+    return;
+  int16_t rowBytes = getRowBytes();
+  uint8_t op = color ? GFX_ROP_OR : GFX_ROP_ANDNOT;
+  for (int16_t j = 0; (j < h) && (gy + j < cy + ch); j++) {
+    // Rows are encoded separately: walk one, expanding it only if visible
+    bool draw = (gy + j >= cy);
+    int16_t k = 0;
+    while (k < srcRowBytes) {
+      uint8_t n = *data++;
+      if (n < 128) {
+        int16_t count = (n + 1 < srcRowBytes - k) ? n + 1 : srcRowBytes - k;
+        if (draw)
+          memcpy(&row[k], data, count);
+        data += n + 1;
+        k += count;
+      } else if (n > 128) {
+        int16_t count = (257 - n < srcRowBytes - k) ? 257 - n : srcRowBytes - k;
+        if (draw)
+          memset(&row[k], *data, count);
+        data++;
+        k += count;
+      }
+    }
+    if (!draw)
+      continue;
+    if (rotation) {
+      Adafruit_GFX::drawBitmap(x, y + j, row, w, 1, color);
+      continue;
+    }
+    blitRow(&buffer[(gy + j) * rowBytes], cx, row, srcRowBytes, cx - gx, cw,
+            op, false);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an 8-bit gray image (0 off, 255 on) as 1-bit pixels. The
+            ordered modes compare each row against a threshold word, 4
+            pixels per 32-bit operation, and store whole bytes; the error
+            diffusion modes carry each pixel's rounding error to the pixels
+            right and below. Rows are dithered into a small buffer and
+            copied with the row blit, so pixels are set and cleared.
+            The Bayer pattern is aligned to the canvas, not to the image.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    gray  Rows of w bytes
+    @param    w   Width of image in pixels (at most 256, or 64 for error
+                  diffusion)
+    @param    h   Height of image in pixels
+    @param    dither  A GFXdither mode, optionally with GFX_DITHER_TEMPORAL:
+                      the pattern then changes with frame, so that quickly
+                      repeated frames average to more levels of gray
+                      (Bayer: each pixel sees all 16 thresholds in 16
+                      frames)
+    @param    frame Frame counter for GFX_DITHER_TEMPORAL
+*/
+/**************************************************************************/
+void GFXcanvas1::drawDitheredBitmap(int16_t x, int16_t y, const uint8_t gray[],
+                                    int16_t w, int16_t h, uint8_t dither,
+                                    uint8_t frame) {
+  uint8_t row[32];
+  int16_t srcRowBytes = (w + 7) / 8;
+  uint8_t mode = dither & ~GFX_DITHER_TEMPORAL;
+  bool temporal = dither & GFX_DITHER_TEMPORAL;
+  bool diffuse = (mode == GFX_DITHER_FLOYD_STEINBERG) ||
+                 (mode == GFX_DITHER_ATKINSON);
+  if (!temporal)
+    frame = 0;
+  if ((w <= 0) || (h <= 0) || (srcRowBytes > (int16_t)sizeof(row)) ||
+      (mode > GFX_DITHER_ATKINSON) || (diffuse && (w > maxDiffusionWidth)))
+    return;
+
+  int16_t gx = x + _originX, gy = y + _originY; // Image origin, absolute
+  int16_t cx = x, cy = y, cw = w, ch = h;
+  if (!clipRect(cx, cy, cw, ch))
+    return;
+  int16_t rowBytes = getRowBytes();
+
+  // Error rows for diffusion, rotated down as the rows are processed
+  int16_t errors[3][maxDiffusionWidth + 4];
+  int16_t *err[3] = {errors[0], errors[1], errors[2]};
+  if (diffuse)
+    memset(errors, 0, sizeof(errors));
+
+  // Errors flow down from the top row, so diffusion starts there; ordered
+  // dithering starts at the first visible row
+  for (int16_t j = diffuse ? 0 : cy - gy; (j < h) && (gy + j < cy + ch);
+       j++) {
+    const uint8_t *src = &gray[j * w];
+    if (diffuse) {
+      ditherDiffusedRow(row, src, w, err, mode, gx, gy + j, frame, temporal);
+      int16_t *done = err[0];
+      err[0] = err[1];
+      err[1] = err[2];
+      err[2] = done;
+      memset(done, 0, (w + 4) * sizeof(int16_t));
+      if (gy + j < cy)
+        continue;
+    } else {
+      ditherOrderedRow(row, src, w, ditherThresholds(mode, gx, gy + j, frame));
+    }
+    if (rotation) {
+      Adafruit_GFX::drawBitmap(x, y + j, row, w, 1, 1, 0);
+      continue;
+    }
+    blitRow(&buffer[(gy + j) * rowBytes], cx, row, srcRowBytes, cx - gx, cw,
+            GFX_ROP_COPY, false);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw the contents of an 8-bit canvas as 1-bit pixels, see the
+            gray bitmap version. The buffer is taken as stored, the source
+            canvas' own rotation does not apply.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    src  8-bit canvas
+    @param    dither  A GFXdither mode, optionally with GFX_DITHER_TEMPORAL
+    @param    frame Frame counter for GFX_DITHER_TEMPORAL
+*/
+/**************************************************************************/
+void GFXcanvas1::drawDitheredBitmap(int16_t x, int16_t y,
+                                    const GFXcanvas8 &src, uint8_t dither,
+                                    uint8_t frame) {
+  if (!src.getBuffer())
+    return;
+  bool swap = src.getRotation() & 1;
+  drawDitheredBitmap(x, y, src.getBuffer(), swap ? src.height() : src.width(),
+                     swap ? src.width() : src.height(), dither, frame);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Row blit behind drawBitmap() and drawUnicodeGlyph(): clipped
+            once, each bitmap row merged into the buffer shifted (one 32-bit
+            window per row for bitmaps up to 24 pixels wide)
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  MSB-first rows of (w + 7) / 8 bytes, directly readable
+    @param    w   Width of bitmap in pixels
+    @param    h   Height of bitmap in pixels
+    @param    color Binary (on or off) color to draw pixels with
+*/
+/**************************************************************************/
+void GFXcanvas1::drawRowBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+                               int16_t w, int16_t h, uint16_t color) {
+  if (rotation) {
+    Adafruit_GFX::drawBitmap(x, y, (uint8_t *)bitmap, w, h, color);
+    return;
+  }
+
+  int16_t gx = x + _originX, gy = y + _originY; // Bitmap origin, absolute
+  int16_t srcRowBytes = (w + 7) / 8;
+  if ((w <= 0) || (h <= 0) || !clipRect(x, y, w, h))
+    return;
+
+  const uint8_t *src = &bitmap[(y - gy) * srcRowBytes];
+  int16_t rowBytes = getRowBytes();
+  uint8_t skip = x - gx, shift = x & 7;
+
+  if ((srcRowBytes <= 3) && (shift + w <= 32)) {
+    // Up to 3 source bytes per row: merge as one shifted 32-bit window
+    uint8_t *dst = &buffer[y * rowBytes + (x >> 3)];
+    uint32_t mask = ((uint32_t)0xFFFFFFFF << (32 - w)) >> shift;
+    uint8_t bytes = (shift + w + 7) >> 3;
+    for (int16_t j = 0; j < h; j++, src += srcRowBytes, dst += rowBytes) {
+      uint32_t bits = 0;
+      for (int16_t k = 0; k < srcRowBytes; k++)
+        bits |= (uint32_t)src[k] << (24 - 8 * k);
+      bits = ((bits << skip) >> shift) & mask;
+      for (uint8_t k = 0; k < bytes; k++) {
+        uint8_t b = bits >> (24 - 8 * k);
+        dst[k] = color ? (dst[k] | b) : (dst[k] & ~b);
+      }
+    }
+    return;
+  }
+
+  uint8_t op = color ? GFX_ROP_OR : GFX_ROP_ANDNOT;
+  for (int16_t j = 0; j < h; j++, src += srcRowBytes) {
+    blitRow(&buffer[(y + j) * rowBytes], x, src, srcRowBytes, skip, w, op,
+            false);
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Map an absolute (viewport-translated) point to raw buffer
+           coordinates
+   @param  x  X coordinate, replaced with the raw coordinate
+   @param  y  Y coordinate, replaced with the raw coordinate
+*/
+/**************************************************************************/
+void GFXcanvas1::rawPoint(int16_t &x, int16_t &y) const {
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Map an absolute (viewport-translated) rectangle to raw buffer
+           coordinates
+   @param  x  Left edge, replaced with the raw left edge
+   @param  y  Top edge, replaced with the raw top edge
+   @param  w  Width, replaced with the raw width
+   @param  h  Height, replaced with the raw height
+*/
+/**************************************************************************/
+void GFXcanvas1::rawRect(int16_t &x, int16_t &y, int16_t &w,
+                         int16_t &h) const {
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - y - h;
+    y = t;
+    t = w;
+    w = h;
+    h = t;
+    break;
+  case 2:
+    x = WIDTH - x - w;
+    y = HEIGHT - y - h;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - t - w;
+    t = w;
+    w = h;
+    h = t;
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Map a movement in rotated coordinates to raw buffer coordinates
+   @param  dx  X distance, replaced with the raw distance
+   @param  dy  Y distance, replaced with the raw distance
+*/
+/**************************************************************************/
+void GFXcanvas1::rawDelta(int16_t &dx, int16_t &dy) const {
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = dx;
+    dx = -dy;
+    dy = t;
+    break;
+  case 2:
+    dx = -dx;
+    dy = -dy;
+    break;
+  case 3:
+    t = dx;
+    dx = dy;
+    dy = -t;
+    break;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Move the contents of the clip rectangle in place. Rows are
+           shifted as multi-byte bit strings, nothing is redrawn.
+   @param  dx     Distance to move right (negative: left)
+   @param  dy     Distance to move down (negative: up)
+   @param  color  Binary (on or off) color for the uncovered pixels
+*/
+/**************************************************************************/
+void GFXcanvas1::scroll(int16_t dx, int16_t dy, uint16_t color) {
+  int16_t x = _clipX0, y = _clipY0;
+  int16_t w = _clipX1 - _clipX0, h = _clipY1 - _clipY0;
+  if ((w <= 0) || (h <= 0))
+    return;
+  rawRect(x, y, w, h);
+  rawDelta(dx, dy);
+
+  int16_t adx = dx < 0 ? -dx : dx, ady = dy < 0 ? -dy : dy;
+  if ((adx >= w) || (ady >= h)) { // Everything scrolls out
+    for (int16_t i = 0; i < h; i++)
+      drawFastRawHLine(x, y + i, w, color);
+    return;
+  }
+
+  int16_t rowBytes = getRowBytes();
+  if ((x == 0) && (w == WIDTH)) { // Whole rows: memmove + byte shifts
+    uint8_t *top = &buffer[y * rowBytes];
+    if (dy > 0)
+      memmove(top + ady * rowBytes, top, (h - ady) * rowBytes);
+    else if (dy < 0)
+      memmove(top, top + ady * rowBytes, (h - ady) * rowBytes);
+    for (int16_t i = 0; dx && (i < h - ady); i++)
+      shiftRow(top + (i + (dy > 0 ? ady : 0)) * rowBytes, rowBytes, dx);
+    if (!color && !(WIDTH & 7)) { // Zeros were shifted in already
+      if (dy > 0)
+        memset(top, 0, ady * rowBytes);
+      else if (dy < 0)
+        memset(top + (h - ady) * rowBytes, 0, ady * rowBytes);
+      return;
+    }
+  } else {
+    blitRect(buffer, rowBytes, x + (dx > 0 ? dx : 0), y + (dy > 0 ? dy : 0),
+             buffer, rowBytes, x + (dx < 0 ? adx : 0),
+             y + (dy < 0 ? ady : 0), w - adx, h - ady, GFX_ROP_COPY);
+  }
+
+  // Fill what was uncovered: whole rows first, then the column strip
+  int16_t keepY = y + (dy > 0 ? dy : 0), keepH = h - ady;
+  for (int16_t i = 0; i < h; i++) {
+    int16_t ry = y + i;
+    if ((ry < keepY) || (ry >= keepY + keepH)) {
+      drawFastRawHLine(x, ry, w, color);
+    } else if (adx) {
+      drawFastRawHLine(dx > 0 ? x : x + w - adx, ry, adx, color);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Rotate the contents of the clip rectangle in place: pixels
+           leaving one edge re-enter at the opposite edge
+   @param  dx  Distance to rotate right (negative: left)
+   @param  dy  Distance to rotate down (negative: up)
+*/
+/**************************************************************************/
+void GFXcanvas1::scrollWrap(int16_t dx, int16_t dy) {
+  int16_t x = _clipX0, y = _clipY0;
+  int16_t w = _clipX1 - _clipX0, h = _clipY1 - _clipY0;
+  if ((w <= 0) || (h <= 0))
+    return;
+  rawRect(x, y, w, h);
+  rawDelta(dx, dy);
+  dx %= w;
+  if (dx < 0)
+    dx += w;
+  dy %= h;
+  if (dy < 0)
+    dy += h;
+
+  int16_t rowBytes = getRowBytes();
+  const int16_t saveBits = 256; // Bits parked per pass
+  uint8_t save[saveBits / 8];
+
+  // Horizontal: park the bits that wrap, shift the rest, put them back
+  for (int16_t i = 0; dx && (i < h); i++) {
+    uint8_t *row = &buffer[(y + i) * rowBytes];
+    for (int16_t left = dx; left > 0; left -= saveBits) {
+      int16_t step = left < saveBits ? left : saveBits;
+      blitRow(save, 0, row, rowBytes, x + w - step, step, GFX_ROP_COPY, false);
+      blitRow(row, x + step, row, rowBytes, x, w - step, GFX_ROP_COPY, true);
+      blitRow(row, x, save, sizeof(save), 0, step, GFX_ROP_COPY, false);
+    }
+  }
+
+  // Vertical: walk the gcd(h, dy) cycles of the row permutation, one
+  // parked row segment per cycle
+  if (!dy)
+    return;
+  int16_t cycles = gcd16(h, dy);
+  for (int16_t cx = x; cx < x + w; cx += saveBits) {
+    int16_t cw = (x + w - cx) < saveBits ? (x + w - cx) : saveBits;
+    for (int16_t start = 0; start < cycles; start++) {
+      blitRow(save, 0, &buffer[(y + start) * rowBytes], rowBytes, cx, cw,
+              GFX_ROP_COPY, false);
+      int16_t cur = start;
+      for (;;) {
+        int16_t prev = (cur - dy + h) % h; // Row that moves into 'cur'
+        if (prev == start)
+          break;
+        blitRow(&buffer[(y + cur) * rowBytes], cx,
+                &buffer[(y + prev) * rowBytes], rowBytes, cx, cw,
+                GFX_ROP_COPY, false);
+        cur = prev;
+      }
+      blitRow(&buffer[(y + cur) * rowBytes], cx, save, sizeof(save), 0, cw,
+              GFX_ROP_COPY, false);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Combine a block of another 1-bit canvas into this one (bitblt).
+           The destination is clipped once; with both canvases unrotated
+           every row is merged a byte at a time with shifts.
+   @param  x    Destination left edge, in viewport coordinates
+   @param  y    Destination top edge, in viewport coordinates
+   @param  src  Source canvas (may be this canvas, overlap is handled)
+   @param  sx   Source left edge, in the source's rotated coordinates
+   @param  sy   Source top edge, in the source's rotated coordinates
+   @param  w    Width of the block in pixels
+   @param  h    Height of the block in pixels
+   @param  op   Raster operation, one of GFX_ROP_*
+*/
+/**************************************************************************/
+void GFXcanvas1::blit(int16_t x, int16_t y, const GFXcanvas1 &src,
+                      int16_t sx, int16_t sy, int16_t w, int16_t h,
+                      uint8_t op) {
+  if ((w <= 0) || (h <= 0))
+    return;
+
+  // Clip the source block to the source canvas
+  if (sx < 0) {
+    x -= sx;
+    w += sx;
+    sx = 0;
+  }
+  if (sy < 0) {
+    y -= sy;
+    h += sy;
+    sy = 0;
+  }
+  if (sx + w > src._width)
+    w = src._width - sx;
+  if (sy + h > src._height)
+    h = src._height - sy;
+  if ((w <= 0) || (h <= 0))
+    return;
+
+  // Clip the destination, dragging the source origin along
+  int16_t ax = x + _originX, ay = y + _originY;
+  if (!clipRect(x, y, w, h))
+    return;
+  sx += x - ax;
+  sy += y - ay;
+
+  if (!rotation && !src.rotation) {
+    blitRect(buffer, getRowBytes(), x, y, src.buffer, src.getRowBytes(), sx,
+             sy, w, h, op);
+    return;
+  }
+
+  // Rotated canvases: pixel by pixel, in an order safe for self-overlap
+  bool upward = (y > sy), backward = (x > sx);
+  for (int16_t j = 0; j < h; j++) {
+    int16_t r = upward ? h - 1 - j : j;
+    for (int16_t i = 0; i < w; i++) {
+      int16_t c = backward ? w - 1 - i : i;
+      int16_t px = sx + c, py = sy + r;
+      src.rawPoint(px, py);
+      uint8_t bit = src.getRawPixel(px, py) ? 0x80 : 0x00;
+      px = x + c;
+      py = y + r;
+      rawPoint(px, py);
+      uint8_t *ptr = &buffer[(px / 8) + py * getRowBytes()];
+      uint8_t shift = px & 7;
+      *ptr = rasterOp(*ptr, bit >> shift, 0x80 >> shift, op);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief  Copy/combine a block of this canvas onto another position of
+           itself. Overlapping areas are handled.
+   @param  x    Destination left edge, in viewport coordinates
+   @param  y    Destination top edge, in viewport coordinates
+   @param  sx   Source left edge, in viewport coordinates
+   @param  sy   Source top edge, in viewport coordinates
+   @param  w    Width of the block in pixels
+   @param  h    Height of the block in pixels
+   @param  op   Raster operation, one of GFX_ROP_*
+*/
+/**************************************************************************/
+void GFXcanvas1::copyRect(int16_t x, int16_t y, int16_t sx, int16_t sy,
+                          int16_t w, int16_t h, uint8_t op) {
+  blit(x, y, *this, sx + _originX, sy + _originY, w, h, op);
+}
+
 /**************************************************************************/
 /*!
    @brief    Speed optimized vertical line drawing into the raw canvas buffer
@@ -2056,53 +3839,27 @@ void GFXcanvas1::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
   int16_t rowBytes = ((WIDTH + 7) / 8);
   uint8_t *buffer = this->getBuffer();
   uint8_t *ptr = &buffer[(x / 8) + y * rowBytes];
-  size_t remainingWidthBits = w;
-
-  // check to see if first byte needs to be partially filled
-  if ((x & 7) > 0) {
-    // create bit mask for first byte
-    uint8_t startByteBitMask = 0x00;
-    for (int8_t i = (x & 7); ((i < 8) && (remainingWidthBits > 0)); i++) {
-#ifdef __AVR__
-      startByteBitMask |= pgm_read_byte(&GFXsetBit[i]);
-#else
-      startByteBitMask |= (0x80 >> i);
-#endif
-      remainingWidthBits--;
-    }
-    if (color > 0) {
-      *ptr |= startByteBitMask;
-    } else {
-      *ptr &= ~startByteBitMask;
-    }
 
-    ptr++;
+  // Edge masks in one step each, whole bytes in between
+  int16_t x1 = x + w - 1;
+  uint8_t startByteBitMask = 0xFF >> (x & 7);
+  uint8_t lastByteBitMask = 0xFF << (7 - (x1 & 7));
+  int16_t bytes = (x1 / 8) - (x / 8);
+  if (bytes == 0) {
+    startByteBitMask &= lastByteBitMask;
   }
 
-  // do the next remainingWidthBits bits
-  if (remainingWidthBits > 0) {
-    size_t remainingWholeBytes = remainingWidthBits / 8;
-    size_t lastByteBits = remainingWidthBits % 8;
-    uint8_t wholeByteColor = color > 0 ? 0xFF : 0x00;
-
-    memset(ptr, wholeByteColor, remainingWholeBytes);
-
-    if (lastByteBits > 0) {
-      uint8_t lastByteBitMask = 0x00;
-      for (size_t i = 0; i < lastByteBits; i++) {
-#ifdef __AVR__
-        lastByteBitMask |= pgm_read_byte(&GFXsetBit[i]);
-#else
-        lastByteBitMask |= (0x80 >> i);
-#endif
-      }
-      ptr += remainingWholeBytes;
-
-      if (color > 0) {
-        *ptr |= lastByteBitMask;
-      } else {
-        *ptr &= ~lastByteBitMask;
-      }
+  if (color > 0) {
+    *ptr |= startByteBitMask;
+  } else {
+    *ptr &= ~startByteBitMask;
+  }
+  if (bytes > 0) {
+    memset(ptr + 1, color > 0 ? 0xFF : 0x00, bytes - 1);
+    if (color > 0) {
+      ptr[bytes] |= lastByteBitMask;
+    } else {
+      ptr[bytes] &= ~lastByteBitMask;
     }
   }
 }
@@ -2141,7 +3898,7 @@ GFXcanvas8::~GFXcanvas8(void) {
 /**************************************************************************/
 void GFXcanvas8::drawPixel(int16_t x, int16_t y, uint16_t color) {
   if (buffer) {
-    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    if (!clipPixel(x, y))
       return;
 
     int16_t t;
@@ -2175,6 +3932,8 @@ void GFXcanvas8::drawPixel(int16_t x, int16_t y, uint16_t color) {
 */
 /**********************************************************************/
 uint8_t GFXcanvas8::getPixel(int16_t x, int16_t y) const {
+  x += _originX;
+  y += _originY;
   int16_t t;
   switch (rotation) {
   case 1:
@@ -2238,28 +3997,12 @@ void GFXcanvas8::fillScreen(uint16_t color) {
 /**************************************************************************/
 void GFXcanvas8::drawFastVLine(int16_t x, int16_t y, int16_t h,
                                uint16_t color) {
-  if (h < 0) { // Convert negative heights to positive equivalent
-    h *= -1;
-    y -= h - 1;
-    if (y < 0) {
-      h += y;
-      y = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((x < 0) || (x >= width()) || (y >= height()) || ((y + h - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t w = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
 
-  if (y < 0) { // Clip top
-    h += y;
-    y = 0;
-  }
-  if (y + h > height()) { // Clip bottom
-    h = height() - y;
-  }
-
   if (getRotation() == 0) {
     drawFastRawVLine(x, y, h, color);
   } else if (getRotation() == 1) {
@@ -2294,29 +4037,12 @@ void GFXcanvas8::drawFastVLine(int16_t x, int16_t y, int16_t h,
 /**************************************************************************/
 void GFXcanvas8::drawFastHLine(int16_t x, int16_t y, int16_t w,
                                uint16_t color) {
-
-  if (w < 0) { // Convert negative widths to positive equivalent
-    w *= -1;
-    x -= w - 1;
-    if (x < 0) {
-      w += x;
-      x = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((y < 0) || (y >= height()) || (x >= width()) || ((x + w - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t h = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
 
-  if (x < 0) { // Clip left
-    w += x;
-    x = 0;
-  }
-  if (x + w >= width()) { // Clip right
-    w = width() - x;
-  }
-
   if (getRotation() == 0) {
     drawFastRawHLine(x, y, w, color);
   } else if (getRotation() == 1) {
@@ -2409,7 +4135,7 @@ GFXcanvas16::~GFXcanvas16(void) {
 /**************************************************************************/
 void GFXcanvas16::drawPixel(int16_t x, int16_t y, uint16_t color) {
   if (buffer) {
-    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    if (!clipPixel(x, y))
       return;
 
     int16_t t;
@@ -2443,6 +4169,8 @@ void GFXcanvas16::drawPixel(int16_t x, int16_t y, uint16_t color) {
 */
 /**********************************************************************/
 uint16_t GFXcanvas16::getPixel(int16_t x, int16_t y) const {
+  x += _originX;
+  y += _originY;
   int16_t t;
   switch (rotation) {
   case 1:
@@ -2533,28 +4261,12 @@ void GFXcanvas16::byteSwap(void) {
 /**************************************************************************/
 void GFXcanvas16::drawFastVLine(int16_t x, int16_t y, int16_t h,
                                 uint16_t color) {
-  if (h < 0) { // Convert negative heights to positive equivalent
-    h *= -1;
-    y -= h - 1;
-    if (y < 0) {
-      h += y;
-      y = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((x < 0) || (x >= width()) || (y >= height()) || ((y + h - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t w = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
 
-  if (y < 0) { // Clip top
-    h += y;
-    y = 0;
-  }
-  if (y + h > height()) { // Clip bottom
-    h = height() - y;
-  }
-
   if (getRotation() == 0) {
     drawFastRawVLine(x, y, h, color);
   } else if (getRotation() == 1) {
@@ -2588,28 +4300,12 @@ void GFXcanvas16::drawFastVLine(int16_t x, int16_t y, int16_t h,
 /**************************************************************************/
 void GFXcanvas16::drawFastHLine(int16_t x, int16_t y, int16_t w,
                                 uint16_t color) {
-  if (w < 0) { // Convert negative widths to positive equivalent
-    w *= -1;
-    x -= w - 1;
-    if (x < 0) {
-      w += x;
-      x = 0;
-    }
-  }
-
-  // Edge rejection (no-draw if totally off canvas)
-  if ((y < 0) || (y >= height()) || (x >= width()) || ((x + w - 1) < 0)) {
+  // Translate into the viewport and clip the whole span once
+  int16_t h = 1;
+  if (!clipRect(x, y, w, h)) {
     return;
   }
 
-  if (x < 0) { // Clip left
-    w += x;
-    x = 0;
-  }
-  if (x + w >= width()) { // Clip right
-    w = width() - x;
-  }
-
   if (getRotation() == 0) {
     drawFastRawHLine(x, y, w, color);
   } else if (getRotation() == 1) {
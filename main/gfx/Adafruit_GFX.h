@@ -7,7 +7,13 @@
 #include "Arduino.h"
 #include "Print.h"
 #endif
+#include "digitfont.h"
 #include "gfxfont.h"
+#include "unicodefont.h"
+
+#ifndef GFX_VIEWPORT_DEPTH
+#define GFX_VIEWPORT_DEPTH 4 ///< Nesting depth of pushViewport()/pushClipRect()
+#endif
 
 /// A generic graphics superclass that can handle all sorts of drawing. At a
 /// minimum you can subclass and provide drawPixel(). At a maximum you can do a
@@ -47,6 +53,16 @@ public:
   virtual void setRotation(uint8_t r);
   virtual void invertDisplay(bool i);
 
+  // VIEWPORT / CLIP API
+  // Coordinates of every primitive are offset by the current origin and
+  // limited to the current clip rectangle (both in rotated coordinates).
+  // Subclasses apply them once per span/blit through clipRect().
+  bool pushViewport(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool pushClipRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  void popViewport(void);
+  void resetViewport(void);
+  void getClipRect(int16_t *x, int16_t *y, uint16_t *w, uint16_t *h) const;
+
   // BASIC DRAW API
   // These MAY be overridden by the subclass to provide device-specific
   // optimized code.  Otherwise 'generic' versions are used.
@@ -106,8 +122,15 @@ public:
                      int16_t w, int16_t h);
   void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
                 uint16_t bg, uint8_t size);
-  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
-                uint16_t bg, uint8_t size_x, uint8_t size_y);
+  virtual void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                        uint16_t bg, uint8_t size_x, uint8_t size_y);
+  virtual void drawUnicodeGlyph(int16_t x, int16_t y,
+                                const GFXunicodeGlyph *glyph, uint16_t color,
+                                uint16_t bg);
+  void drawCodepoint(int16_t x, int16_t y, uint32_t codepoint);
+  uint8_t getAdvance(uint32_t codepoint);
+  uint8_t getLineHeight(void) const;
+  int16_t getTextAscent(void) const;
   void getTextBounds(const char *string, int16_t x, int16_t y, int16_t *x1,
                      int16_t *y1, uint16_t *w, uint16_t *h);
   void getTextBounds(const __FlashStringHelper *s, int16_t x, int16_t y,
@@ -117,6 +140,7 @@ public:
   void setTextSize(uint8_t s);
   void setTextSize(uint8_t sx, uint8_t sy);
   void setFont(const GFXfont *f = NULL);
+  void setUnicodeFont(GFXunicodeFont *f = NULL);
 
   /**********************************************************************/
   /*!
@@ -183,6 +207,7 @@ public:
 #else
   virtual size_t write(uint8_t);
 #endif
+  size_t write(const char *buffer, size_t size);
 
   /************************************************************************/
   /*!
@@ -226,7 +251,103 @@ public:
   /************************************************************************/
   int16_t getCursorY(void) const { return cursor_y; };
 
+  /************************************************************************/
+  /*!
+    @brief      Get the font set with setUnicodeFont()
+    @returns    The Unicode font, NULL if text is 8-bit
+  */
+  /************************************************************************/
+  GFXunicodeFont *getUnicodeFont(void) const { return unicodeFont; }
+
+  /************************************************************************/
+  /*!
+    @brief      Get X offset of the current viewport
+    @returns    X origin in pixels, relative to the (rotated) display
+  */
+  /************************************************************************/
+  int16_t getOriginX(void) const { return _originX; }
+
+  /************************************************************************/
+  /*!
+    @brief      Get Y offset of the current viewport
+    @returns    Y origin in pixels, relative to the (rotated) display
+  */
+  /************************************************************************/
+  int16_t getOriginY(void) const { return _originY; }
+
 protected:
+  /**********************************************************************/
+  /*!
+    @brief  Translate a pixel into the current viewport and test it
+            against the clip rectangle
+    @param  x  X coordinate, replaced with the absolute coordinate
+    @param  y  Y coordinate, replaced with the absolute coordinate
+    @returns  true if the pixel is visible
+  */
+  /**********************************************************************/
+  bool clipPixel(int16_t &x, int16_t &y) const {
+    x += _originX;
+    y += _originY;
+    return (x >= _clipX0) && (y >= _clipY0) && (x < _clipX1) && (y < _clipY1);
+  }
+
+  /**********************************************************************/
+  /*!
+    @brief  Translate a rectangle into the current viewport and clip it.
+            Negative sizes extend left/up from x/y, like drawFastHLine().
+    @param  x  Left edge, replaced with the clipped absolute edge
+    @param  y  Top edge, replaced with the clipped absolute edge
+    @param  w  Width, replaced with the clipped width
+    @param  h  Height, replaced with the clipped height
+    @returns  false if nothing of the rectangle is visible
+  */
+  /**********************************************************************/
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const {
+    int32_t x0 = (int32_t)x + _originX, y0 = (int32_t)y + _originY;
+    int32_t x1 = x0 + w, y1 = y0 + h;
+    if (w < 0) {
+      x1 = x0 + 1;
+      x0 = x1 + w;
+    }
+    if (h < 0) {
+      y1 = y0 + 1;
+      y0 = y1 + h;
+    }
+    if (x0 < _clipX0)
+      x0 = _clipX0;
+    if (y0 < _clipY0)
+      y0 = _clipY0;
+    if (x1 > _clipX1)
+      x1 = _clipX1;
+    if (y1 > _clipY1)
+      y1 = _clipY1;
+    if ((x0 >= x1) || (y0 >= y1))
+      return false;
+    x = x0;
+    y = y0;
+    w = x1 - x0;
+    h = y1 - y0;
+    return true;
+  }
+
+  /**********************************************************************/
+  /*!
+    @brief  Quick reject test for a whole primitive (glyph, bitmap...)
+    @param  x  Left edge in viewport coordinates
+    @param  y  Top edge in viewport coordinates
+    @param  w  Width in pixels
+    @param  h  Height in pixels
+    @returns  true if the rectangle lies completely outside the clip
+  */
+  /**********************************************************************/
+  bool isClipped(int16_t x, int16_t y, int16_t w, int16_t h) const {
+    int32_t x0 = (int32_t)x + _originX, y0 = (int32_t)y + _originY;
+    return (x0 >= _clipX1) || (y0 >= _clipY1) || (x0 + w <= _clipX0) ||
+           (y0 + h <= _clipY0);
+  }
+
+  void writeCodepoint(uint32_t codepoint);
+  virtual void drawTextRun(int16_t x, int16_t y, const char *text, size_t n);
   void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx,
                   int16_t *miny, int16_t *maxx, int16_t *maxy);
   int16_t WIDTH;        ///< This is the 'raw' display width - never changes
@@ -243,6 +364,24 @@ protected:
   bool wrap;            ///< If set, 'wrap' text at right edge of display
   bool _cp437;          ///< If set, use correct CP437 charset (default is off)
   GFXfont *gfxFont;     ///< Pointer to special font
+  int8_t _fontAscent;   ///< Rows above the baseline used by gfxFont glyphs
+  int8_t _fontDescent;  ///< Rows below the baseline used by gfxFont glyphs
+  GFXunicodeFont *unicodeFont; ///< If set, write() decodes UTF-8 through it
+  GFXutf8Decoder _utf8;        ///< write()'s partial UTF-8 sequence
+  int16_t _originX;     ///< Viewport X offset, added to every coordinate
+  int16_t _originY;     ///< Viewport Y offset, added to every coordinate
+  int16_t _clipX0;      ///< Clip rectangle left edge (inclusive)
+  int16_t _clipY0;      ///< Clip rectangle top edge (inclusive)
+  int16_t _clipX1;      ///< Clip rectangle right edge (exclusive)
+  int16_t _clipY1;      ///< Clip rectangle bottom edge (exclusive)
+
+private:
+  /// Saved origin and clip state of one pushViewport()/pushClipRect()
+  struct Viewport {
+    int16_t originX, originY, clipX0, clipY0, clipX1, clipY1;
+  };
+  Viewport _viewportStack[GFX_VIEWPORT_DEPTH]; ///< Saved viewports
+  uint8_t _viewportDepth;                      ///< Number of saved viewports
 };
 
 /// A simple drawn button UI element
@@ -303,16 +442,88 @@ private:
   bool currstate, laststate;
 };
 
+/// Raster operations combining a 1-bit source block with the destination
+enum GFXrop : uint8_t {
+  GFX_ROP_COPY,   ///< dst = src
+  GFX_ROP_OR,     ///< dst |= src
+  GFX_ROP_AND,    ///< dst &= src
+  GFX_ROP_XOR,    ///< dst ^= src
+  GFX_ROP_ANDNOT, ///< dst &= ~src
+};
+
+/// Conversions of 8-bit gray (0 black, 255 white) to 1-bit pixels
+enum GFXdither : uint8_t {
+  GFX_DITHER_THRESHOLD,       ///< Lit from 128 up
+  GFX_DITHER_BAYER,           ///< 4x4 ordered dither, 17 levels
+  GFX_DITHER_FLOYD_STEINBERG, ///< Error diffusion to 4 neighbours
+  GFX_DITHER_ATKINSON,        ///< 3/4 of the error diffused to 6 neighbours
+  GFX_DITHER_TEMPORAL = 0x80, ///< Flag: change the pattern with each frame
+};
+
+class GFXcanvas8;
+
+/**************************************************************************/
+/*!
+    @brief  Pack the first bytes of a 1-bit row into one word, leftmost pixel
+            in bit 31: the row format of drawBitmap() with uint32_t rows
+    @param  line   Row bytes, MSB-first (a canvas buffer row or bitmap row)
+    @param  bytes  Number of bytes to take, at most 4
+    @returns  The row word, the bits past the taken bytes clear
+*/
+/**************************************************************************/
+inline uint32_t gfxRowWord(const uint8_t *line, uint8_t bytes) {
+  uint32_t row = 0;
+  for (uint8_t i = 0; i < bytes; i++)
+    row |= (uint32_t)line[i] << (24 - 8 * i);
+  return row;
+}
+
 /// A GFX 1-bit canvas context for graphics
 class GFXcanvas1 : public Adafruit_GFX {
 public:
   GFXcanvas1(uint16_t w, uint16_t h);
+  GFXcanvas1(uint16_t w, uint16_t h, uint8_t *storage);
   ~GFXcanvas1(void);
   void drawPixel(int16_t x, int16_t y, uint16_t color);
   void fillScreen(uint16_t color);
   void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillRawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  using Adafruit_GFX::drawChar;
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y);
+  void drawNumber(uint32_t value, uint8_t digits, const GFXdigitFont *font);
+  void drawUnicodeGlyph(int16_t x, int16_t y, const GFXunicodeGlyph *glyph,
+                        uint16_t color, uint16_t bg);
+  using Adafruit_GFX::drawBitmap;
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                  uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint32_t rows[], int16_t w,
+                  int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint32_t rows[], int16_t w,
+                  int16_t h, uint16_t color, uint16_t bg);
+  void drawShiftedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                         int16_t w, int16_t h, uint16_t color);
+  void drawRLEBitmap(int16_t x, int16_t y, const uint8_t data[], int16_t w,
+                     int16_t h, uint16_t color);
+  void drawDitheredBitmap(int16_t x, int16_t y, const uint8_t gray[],
+                          int16_t w, int16_t h,
+                          uint8_t dither = GFX_DITHER_BAYER,
+                          uint8_t frame = 0);
+  void drawDitheredBitmap(int16_t x, int16_t y, const GFXcanvas8 &src,
+                          uint8_t dither = GFX_DITHER_BAYER,
+                          uint8_t frame = 0);
+  void setRotation(uint8_t r);
   bool getPixel(int16_t x, int16_t y) const;
+  void scroll(int16_t dx, int16_t dy, uint16_t color = 0);
+  void scrollWrap(int16_t dx, int16_t dy);
+  void blit(int16_t x, int16_t y, const GFXcanvas1 &src, int16_t sx,
+            int16_t sy, int16_t w, int16_t h, uint8_t op = GFX_ROP_COPY);
+  void copyRect(int16_t x, int16_t y, int16_t sx, int16_t sy, int16_t w,
+                int16_t h, uint8_t op = GFX_ROP_COPY);
   /**********************************************************************/
   /*!
     @brief    Get a pointer to the internal buffer memory
@@ -321,13 +532,49 @@ public:
   /**********************************************************************/
   uint8_t *getBuffer(void) const { return buffer; }
 
+  /**********************************************************************/
+  /*!
+    @brief    Get the number of bytes per buffer row (scanline pad)
+    @returns  Bytes per unrotated row
+  */
+  /**********************************************************************/
+  int16_t getRowBytes(void) const { return (WIDTH + 7) / 8; }
+
 protected:
   bool getRawPixel(int16_t x, int16_t y) const;
+  void rawPoint(int16_t &x, int16_t &y) const;
+  void rawRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+  void rawDelta(int16_t &dx, int16_t &dy) const;
   void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawTextRun(int16_t x, int16_t y, const char *text, size_t n);
 
 private:
+  void drawFontChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                    uint16_t bg);
+  void drawDigitCell(int16_t x, int16_t y, const uint16_t *rows, int16_t w,
+                     int16_t h);
+  void drawRowBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w,
+                     int16_t h, uint16_t color);
+  void drawScaledChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                      uint16_t bg, uint8_t size_x, uint8_t size_y);
+  void bindRotation(void);
+  template <uint8_t R> void drawPixelRot(int16_t x, int16_t y, uint16_t color);
+  template <uint8_t R> bool getPixelRot(int16_t x, int16_t y) const;
+  template <uint8_t R>
+  void drawFastVLineRot(int16_t x, int16_t y, int16_t h, uint16_t color);
+  template <uint8_t R>
+  void drawFastHLineRot(int16_t x, int16_t y, int16_t w, uint16_t color);
+
   uint8_t *buffer;
+  bool buffer_owned; ///< Allocated by the constructor, freed on destruction
+
+  // Rotation-specialized paths, bound once by setRotation(). They take
+  // absolute, already clipped coordinates.
+  void (GFXcanvas1::*_drawPixelFn)(int16_t, int16_t, uint16_t);
+  bool (GFXcanvas1::*_getPixelFn)(int16_t, int16_t) const;
+  void (GFXcanvas1::*_drawFastVLineFn)(int16_t, int16_t, int16_t, uint16_t);
+  void (GFXcanvas1::*_drawFastHLineFn)(int16_t, int16_t, int16_t, uint16_t);
 
 #ifdef __AVR__
   // Bitmask tables of 0x80>>X and ~(0x80>>X), because X>>Y is slow on AVR
@@ -335,6 +582,30 @@ private:
 #endif
 };
 
+/// Statically sized pixel storage, a base class so it is constructed before
+/// the canvas that points into it
+template <size_t N> struct GFXcanvasStorage {
+  uint8_t storage[N]; ///< Raw canvas bytes
+};
+
+/// Number of buffer bytes of a W x H 1-bit canvas
+#define GFX_CANVAS1_BYTES(W, H) ((((W) + 7) / 8) * (H))
+
+/// A GFX 1-bit canvas whose buffer is part of the object, so a static or
+/// global instance lives entirely in .bss and never touches the heap
+template <uint16_t W, uint16_t H>
+class GFXstaticCanvas1 : private GFXcanvasStorage<GFX_CANVAS1_BYTES(W, H)>,
+                         public GFXcanvas1 {
+public:
+  /**********************************************************************/
+  /*!
+    @brief    Instantiate a W x H 1-bit canvas on its own storage
+  */
+  /**********************************************************************/
+  GFXstaticCanvas1(void)
+      : GFXcanvas1(W, H, GFXcanvasStorage<GFX_CANVAS1_BYTES(W, H)>::storage) {}
+};
+
 /// A GFX 8-bit canvas context for graphics
 class GFXcanvas8 : public Adafruit_GFX {
 public:
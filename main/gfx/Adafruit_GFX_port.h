@@ -17,6 +17,22 @@ public:
     inline void print(const char* str) {
         write(str, strlen(str));
     }
+    // Decimal number, left padded with pad to at least width characters,
+    // formatted without printf and handed to write() in one piece
+    size_t printNumber(long value, uint8_t width = 0, char pad = '0') {
+        char buf[24];
+        char* p = buf + sizeof(buf);
+        unsigned long n = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+        do {
+            *--p = '0' + n % 10;
+            n /= 10;
+        } while (n);
+        if (width > sizeof(buf) - 1) width = sizeof(buf) - 1;
+        if (value < 0 && pad != '0') *--p = '-';
+        while (buf + sizeof(buf) - p < width - (value < 0 && pad == '0')) *--p = pad;
+        if (value < 0 && pad == '0') *--p = '-';
+        return write(p, buf + sizeof(buf) - p);
+    }
 };
 
 class __FlashStringHelper {};
@@ -0,0 +1,404 @@
+// Compile-time converters from hand-written bitmap sources to the formats
+// GFXcanvas1 draws directly. Every function is constexpr (C++14): assign
+// the result to a constexpr variable and the converted data is emitted as
+// const data in flash, nothing is transformed when drawing.
+//
+//   static constexpr uint8_t logoSrc[] = {0b10000001, ...};
+//   static constexpr auto logo = gfxBakeRows<8, 8>(logoSrc);
+//   static constexpr auto logoRLE = gfxBakeRLE<gfxRLESize(logo)>(logo);
+//   canvas->drawBitmap(x, y, logo.rows[0], logo.width, logo.height, 1);
+//   canvas->drawRLEBitmap(x, y, logoRLE.data, logo.width, logo.height, 1);
+//
+//   static constexpr GFXbitmap<8, 8> blinkFrames[] = {open, shut};
+//   static constexpr uint16_t blinkMs[] = {2000, 150};
+//   static constexpr auto blink =
+//       gfxBakeDelta<gfxDeltaSize(blinkFrames, blinkMs)>(blinkFrames, blinkMs);
+//   animation.load(blink.data, sizeof(blink.data));  // a DeltaAnimation
+
+#ifndef _BITMAPBAKE_H_
+#define _BITMAPBAKE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Canvas-native bitmap: MSB-first rows (leftmost pixel in bit 7), each
+/// padded to whole bytes with zero bits, as drawBitmap() takes them
+template <uint16_t W, uint16_t H> struct GFXbitmap {
+  static constexpr int16_t width = W;                ///< Width in pixels
+  static constexpr int16_t height = H;               ///< Height in pixels
+  static constexpr int16_t rowBytes = (W + 7) / 8;   ///< Bytes per row
+  uint8_t rows[H][(W + 7) / 8];                      ///< Pixel rows
+};
+
+/// Fixed-width font of up to 8 pixel wide glyphs: one byte per glyph row
+template <uint16_t N, uint16_t H> struct GFXrowFont {
+  uint8_t rows[N][H]; ///< Rows of glyph n, MSB-first
+};
+
+/// Bitmap up to 32 pixels wide, one word per row (leftmost pixel in bit 31)
+template <uint16_t W, uint16_t H> struct GFXwordBitmap {
+  static constexpr int16_t width = W;  ///< Width in pixels
+  static constexpr int16_t height = H; ///< Height in pixels
+  uint32_t rows[H];                    ///< Pixel rows
+};
+
+/// The bitmap shifted right by 0-7 pixels: drawShiftedBitmap() picks the
+/// copy matching x % 8, so every row lands on whole destination bytes
+template <uint16_t W, uint16_t H> struct GFXshiftedBitmap {
+  static constexpr int16_t width = W;                     ///< Width in pixels
+  static constexpr int16_t height = H;                    ///< Height in pixels
+  static constexpr int16_t rowBytes = (W + 7) / 8 + 1;    ///< Bytes per row
+  uint8_t rows[8][H][(W + 7) / 8 + 1];                    ///< [phase][row]
+};
+
+/// PackBits-compressed rows for drawRLEBitmap(). Each row of the bitmap is
+/// encoded on its own: a header byte n < 128 is followed by n + 1 literal
+/// bytes, n > 128 by one byte repeated 257 - n times.
+template <uint16_t W, uint16_t H, size_t N> struct GFXrleBitmap {
+  static constexpr int16_t width = W;  ///< Width in pixels
+  static constexpr int16_t height = H; ///< Height in pixels
+  uint8_t data[N];                     ///< Encoded rows, top to bottom
+};
+
+/**************************************************************************/
+/*!
+    @brief  Take MSB-first rows as written with 0b... literals, clearing any
+            bits beyond the width
+    @param  src  H rows of (W + 7) / 8 bytes
+    @returns  The bitmap
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t N>
+constexpr GFXbitmap<W, H> gfxBakeRows(const uint8_t (&src)[N]) {
+  static_assert(N == (size_t)H * ((W + 7) / 8), "bitmap size mismatch");
+  GFXbitmap<W, H> b{};
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t i = 0; i < (W + 7) / 8; i++) {
+      uint8_t keep = (W - i * 8 >= 8) ? 0xFF : (uint8_t)(0xFF << (8 - (W - i * 8)));
+      b.rows[y][i] = src[y * ((W + 7) / 8) + i] & keep;
+    }
+  }
+  return b;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Convert XBM data (LSB-first rows, as drawXBitmap() takes)
+    @param  src  H rows of (W + 7) / 8 bytes
+    @returns  The bitmap
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t N>
+constexpr GFXbitmap<W, H> gfxBakeXBM(const uint8_t (&src)[N]) {
+  static_assert(N == (size_t)H * ((W + 7) / 8), "bitmap size mismatch");
+  GFXbitmap<W, H> b{};
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t x = 0; x < W; x++) {
+      if (src[y * ((W + 7) / 8) + x / 8] & (1 << (x & 7)))
+        b.rows[y][x / 8] |= 0x80 >> (x & 7);
+    }
+  }
+  return b;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Transpose column-major data, the layout of glcdfont.c and of
+            most LCD controller fonts: byte (y / 8) * W + x holds column x,
+            pixel y in bit (y % 8)
+    @param  src  (H + 7) / 8 pages of W column bytes
+    @returns  The bitmap
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t N>
+constexpr GFXbitmap<W, H> gfxBakeColumns(const uint8_t (&src)[N]) {
+  static_assert(N == (size_t)W * ((H + 7) / 8), "bitmap size mismatch");
+  GFXbitmap<W, H> b{};
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t x = 0; x < W; x++) {
+      if (src[(y / 8) * W + x] & (1 << (y & 7)))
+        b.rows[y][x / 8] |= 0x80 >> (x & 7);
+    }
+  }
+  return b;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Transpose a column-major font of N glyphs, each W column bytes
+            with pixel y in bit y (glcdfont.c: N = 256, W = 5, H = 8)
+    @param  src  N * W column bytes
+    @returns  The glyph rows
+*/
+/**************************************************************************/
+template <uint16_t N, uint16_t W, uint16_t H, size_t S>
+constexpr GFXrowFont<N, H> gfxBakeColumnFont(const uint8_t (&src)[S]) {
+  static_assert((W <= 8) && (H <= 8), "glyphs must fit 8x8");
+  static_assert(S >= (size_t)N * W, "font data too short");
+  GFXrowFont<N, H> f{};
+  for (uint16_t g = 0; g < N; g++) {
+    for (uint16_t x = 0; x < W; x++) {
+      uint8_t column = src[g * W + x];
+      for (uint16_t y = 0; y < H; y++) {
+        if (column & (1 << y))
+          f.rows[g][y] |= 0x80 >> x;
+      }
+    }
+  }
+  return f;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Pack each row into one word, for drawBitmap() with uint32_t rows
+    @param  b  Bitmap up to 32 pixels wide
+    @returns  The word rows
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H>
+constexpr GFXwordBitmap<W, H> gfxBakeWords(const GFXbitmap<W, H> &b) {
+  static_assert(W <= 32, "word rows hold up to 32 pixels");
+  GFXwordBitmap<W, H> out{};
+  for (uint16_t y = 0; y < H; y++) {
+    for (uint16_t i = 0; i < (W + 7) / 8; i++)
+      out.rows[y] |= (uint32_t)b.rows[y][i] << (24 - 8 * i);
+  }
+  return out;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Pre-shift the bitmap for all eight x % 8 phases
+    @param  b  The bitmap
+    @returns  The eight shifted copies
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H>
+constexpr GFXshiftedBitmap<W, H> gfxBakeShifted(const GFXbitmap<W, H> &b) {
+  GFXshiftedBitmap<W, H> out{};
+  for (uint8_t p = 0; p < 8; p++) {
+    for (uint16_t y = 0; y < H; y++) {
+      for (uint16_t i = 0; i < (W + 7) / 8; i++) {
+        out.rows[p][y][i] |= b.rows[y][i] >> p;
+        out.rows[p][y][i + 1] |= (uint8_t)(b.rows[y][i] << (8 - p));
+      }
+    }
+  }
+  return out;
+}
+
+/**************************************************************************/
+/*!
+    @brief  PackBits-encode the rows of a bitmap (helper of gfxRLESize()
+            and gfxBakeRLE())
+    @param  b    The bitmap
+    @param  out  Output buffer, or nullptr to only count
+    @returns  Number of encoded bytes
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H>
+constexpr size_t gfxPackBits(const GFXbitmap<W, H> &b, uint8_t *out) {
+  const uint16_t n = (W + 7) / 8;
+  size_t size = 0;
+  for (uint16_t y = 0; y < H; y++) {
+    const uint8_t *row = b.rows[y];
+    uint16_t i = 0;
+    while (i < n) {
+      uint16_t run = 1;
+      while ((i + run < n) && (run < 128) && (row[i + run] == row[i]))
+        run++;
+      if (run >= 2) {
+        if (out) {
+          out[size] = (uint8_t)(257 - run);
+          out[size + 1] = row[i];
+        }
+        size += 2;
+        i += run;
+        continue;
+      }
+      uint16_t literal = 1; // Up to the next repeated pair
+      while ((i + literal < n) && (literal < 128) &&
+             !((i + literal + 1 < n) && (row[i + literal] == row[i + literal + 1])))
+        literal++;
+      if (out) {
+        out[size] = (uint8_t)(literal - 1);
+        for (uint16_t k = 0; k < literal; k++)
+          out[size + 1 + k] = row[i + k];
+      }
+      size += 1 + literal;
+      i += literal;
+    }
+  }
+  return size;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Size of the RLE encoding, the template argument of gfxBakeRLE()
+    @param  b  The bitmap
+    @returns  Number of encoded bytes
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H>
+constexpr size_t gfxRLESize(const GFXbitmap<W, H> &b) {
+  return gfxPackBits(b, nullptr);
+}
+
+/**************************************************************************/
+/*!
+    @brief  RLE-encode a bitmap
+    @param  b  The bitmap
+    @returns  The encoded rows, N must be gfxRLESize(b)
+*/
+/**************************************************************************/
+template <size_t N, uint16_t W, uint16_t H>
+constexpr GFXrleBitmap<W, H, N> gfxBakeRLE(const GFXbitmap<W, H> &b) {
+  GFXrleBitmap<W, H, N> out{};
+  gfxPackBits(b, out.data);
+  return out;
+}
+
+/// Frames as XOR deltas for DeltaAnimation (matrix/DeltaAnimation.h), the
+/// format tools/mkassets.py --anim writes
+template <size_t N> struct GFXdeltaAnimation {
+  uint8_t data[N]; ///< Header and delta records
+};
+
+/**************************************************************************/
+/*!
+    @brief  Byte i of the change record r (helper of gfxDeltaEncode()):
+            frame r against frame r - 1, frame 0 against a blank frame and,
+            for r == F, the last frame against frame 0
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t F>
+constexpr uint8_t gfxDeltaByte(const GFXbitmap<W, H> (&frames)[F], size_t r,
+                               size_t i) {
+  const uint16_t n = (W + 7) / 8;
+  uint8_t to = frames[r < F ? r : 0].rows[i / n][i % n];
+  uint8_t from = (r == 0) ? 0 : frames[r - 1].rows[i / n][i % n];
+  return to ^ from;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode frames as a DeltaAnimation (helper of gfxDeltaSize() and
+            gfxBakeDelta()). Unchanged bytes are skipped, changed ones
+            PackBits-coded: a run of 3 or more equal bytes is repeated, a
+            literal runs on until two unchanged bytes or a repeat.
+    @param  frames   The frames
+    @param  frameMs  How long each frame is shown, in ms
+    @param  out      Output buffer, or nullptr to only count
+    @returns  Number of encoded bytes
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t F>
+constexpr size_t gfxDeltaEncode(const GFXbitmap<W, H> (&frames)[F],
+                                const uint16_t (&frameMs)[F], uint8_t *out) {
+  static_assert(F > 0 && F < 65536, "1 to 65535 frames");
+  const size_t n = (size_t)((W + 7) / 8) * H;
+  const uint16_t header[4] = {W, H, (uint16_t)F, 0};
+  size_t size = 0;
+  for (uint8_t k = 0; k < 4; k++) {
+    if (out) {
+      out[size] = (uint8_t)header[k];
+      out[size + 1] = (uint8_t)(header[k] >> 8);
+    }
+    size += 2;
+  }
+  for (size_t r = 0; r <= F; r++) {
+    const size_t start = size;
+    size += 4;
+    size_t skip = 0;
+    for (size_t i = 0; i < n;) {
+      uint8_t d = gfxDeltaByte(frames, r, i);
+      if (!d) {
+        skip++;
+        i++;
+        continue;
+      }
+      for (; skip > 255; skip -= 255) { // skip-only ops
+        if (out) {
+          out[size] = 255;
+          out[size + 1] = 128;
+        }
+        size += 2;
+      }
+      if (out)
+        out[size] = (uint8_t)skip;
+      size++;
+      skip = 0;
+      size_t run = 1;
+      while ((i + run < n) && (run < 128) &&
+             (gfxDeltaByte(frames, r, i + run) == d))
+        run++;
+      if (run >= 3) {
+        if (out) {
+          out[size] = (uint8_t)(257 - run);
+          out[size + 1] = d;
+        }
+        size += 2;
+        i += run;
+        continue;
+      }
+      size_t literal = 1;
+      while ((i + literal < n) && (literal < 128)) {
+        size_t j = i + literal;
+        uint8_t dj = gfxDeltaByte(frames, r, j);
+        if (!dj && ((j + 1 >= n) || !gfxDeltaByte(frames, r, j + 1)))
+          break;
+        if (dj && (j + 2 < n) && (gfxDeltaByte(frames, r, j + 1) == dj) &&
+            (gfxDeltaByte(frames, r, j + 2) == dj))
+          break;
+        literal++;
+      }
+      if (out) {
+        out[size] = (uint8_t)(literal - 1);
+        for (size_t k = 0; k < literal; k++)
+          out[size + 1 + k] = gfxDeltaByte(frames, r, i + k);
+      }
+      size += 1 + literal;
+      i += literal;
+    }
+    if (out) {
+      uint16_t ms = (r < F) ? frameMs[r] : 0;
+      out[start] = (uint8_t)ms;
+      out[start + 1] = (uint8_t)(ms >> 8);
+      out[start + 2] = (uint8_t)(size - start - 4);
+      out[start + 3] = (uint8_t)((size - start - 4) >> 8);
+    }
+  }
+  return size;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Size of the encoding, the template argument of gfxBakeDelta()
+    @param  frames   The frames
+    @param  frameMs  How long each frame is shown, in ms
+    @returns  Number of encoded bytes
+*/
+/**************************************************************************/
+template <uint16_t W, uint16_t H, size_t F>
+constexpr size_t gfxDeltaSize(const GFXbitmap<W, H> (&frames)[F],
+                              const uint16_t (&frameMs)[F]) {
+  return gfxDeltaEncode(frames, frameMs, nullptr);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Encode frames for DeltaAnimation::load()
+    @param  frames   The frames
+    @param  frameMs  How long each frame is shown, in ms
+    @returns  The animation, N must be gfxDeltaSize(frames, frameMs)
+*/
+/**************************************************************************/
+template <size_t N, uint16_t W, uint16_t H, size_t F>
+constexpr GFXdeltaAnimation<N>
+gfxBakeDelta(const GFXbitmap<W, H> (&frames)[F], const uint16_t (&frameMs)[F]) {
+  GFXdeltaAnimation<N> out{};
+  gfxDeltaEncode(frames, frameMs, out.data);
+  return out;
+}
+
+#endif // _BITMAPBAKE_H_
@@ -0,0 +1,86 @@
+// Glyph data of the numeral fonts declared in digitfont.h, and the
+// compile-time expansion into two-digit pair rows.
+
+#include "digitfont.h"
+
+// C++14 constexpr: the pair tables are computed by the compiler and end up
+// in flash like any other const data
+static constexpr GFXdigitFont makeDigitFont(uint8_t w, uint8_t h,
+                                            uint8_t xAdvance,
+                                            const uint8_t (&glyph)[10][8]) {
+  GFXdigitFont f{};
+  f.width = w;
+  f.height = h;
+  f.xAdvance = xAdvance;
+  for (int d = 0; d < 10; d++) {
+    for (int r = 0; r < 8; r++)
+      f.glyph[d][r] = glyph[d][r];
+  }
+  for (int v = 0; v < 100; v++) {
+    for (int r = 0; r < 8; r++) {
+      uint16_t tens = (uint16_t)glyph[v / 10][r] << 8;
+      uint16_t units = (uint16_t)glyph[v % 10][r] << 8;
+      f.pair[v][r] = tens | (units >> xAdvance);
+    }
+  }
+  return f;
+}
+
+static constexpr uint8_t Digits3x5Glyphs[10][8] = {
+    {0xE0, 0xA0, 0xA0, 0xA0, 0xE0}, // 0
+    {0x40, 0xC0, 0x40, 0x40, 0xE0}, // 1
+    {0xE0, 0x20, 0xE0, 0x80, 0xE0}, // 2
+    {0xE0, 0x20, 0xE0, 0x20, 0xE0}, // 3
+    {0xA0, 0xA0, 0xE0, 0x20, 0x20}, // 4
+    {0xE0, 0x80, 0xE0, 0x20, 0xE0}, // 5
+    {0xE0, 0x80, 0xE0, 0xA0, 0xE0}, // 6
+    {0xE0, 0x20, 0x20, 0x20, 0x20}, // 7
+    {0xE0, 0xA0, 0xE0, 0xA0, 0xE0}, // 8
+    {0xE0, 0xA0, 0xE0, 0x20, 0xE0}, // 9
+};
+
+static constexpr uint8_t Digits4x7Glyphs[10][8] = {
+    {0x60, 0x90, 0x90, 0x90, 0x90, 0x90, 0x60}, // 0
+    {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70}, // 1
+    {0x60, 0x90, 0x10, 0x20, 0x40, 0x80, 0xF0}, // 2
+    {0x60, 0x90, 0x10, 0x20, 0x10, 0x90, 0x60}, // 3
+    {0x20, 0x60, 0xA0, 0xA0, 0xF0, 0x20, 0x20}, // 4
+    {0xF0, 0x80, 0xE0, 0x10, 0x10, 0x90, 0x60}, // 5
+    {0x60, 0x80, 0xE0, 0x90, 0x90, 0x90, 0x60}, // 6
+    {0xF0, 0x10, 0x20, 0x20, 0x40, 0x40, 0x40}, // 7
+    {0x60, 0x90, 0x90, 0x60, 0x90, 0x90, 0x60}, // 8
+    {0x60, 0x90, 0x90, 0x70, 0x10, 0x10, 0x60}, // 9
+};
+
+static constexpr uint8_t Digits5x7BoldGlyphs[10][8] = {
+    {0x70, 0xD8, 0xD8, 0xD8, 0xD8, 0xD8, 0x70}, // 0
+    {0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0x78}, // 1
+    {0x70, 0xD8, 0x18, 0x30, 0x60, 0xC0, 0xF8}, // 2
+    {0xF0, 0x18, 0x18, 0x70, 0x18, 0x18, 0xF0}, // 3
+    {0x18, 0x38, 0x78, 0xD8, 0xF8, 0x18, 0x18}, // 4
+    {0xF8, 0xC0, 0xF0, 0x18, 0x18, 0xD8, 0x70}, // 5
+    {0x70, 0xC0, 0xF0, 0xD8, 0xD8, 0xD8, 0x70}, // 6
+    {0xF8, 0x18, 0x30, 0x30, 0x60, 0x60, 0x60}, // 7
+    {0x70, 0xD8, 0xD8, 0x70, 0xD8, 0xD8, 0x70}, // 8
+    {0x70, 0xD8, 0xD8, 0x78, 0x18, 0x18, 0x70}, // 9
+};
+
+static constexpr uint8_t Digits6x8WideGlyphs[10][8] = {
+    {0x78, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0x78}, // 0
+    {0x30, 0x70, 0xF0, 0x30, 0x30, 0x30, 0x30, 0xFC}, // 1
+    {0x78, 0xCC, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0xFC}, // 2
+    {0x78, 0xCC, 0x0C, 0x38, 0x0C, 0x0C, 0xCC, 0x78}, // 3
+    {0x18, 0x38, 0x78, 0xD8, 0xFC, 0x18, 0x18, 0x18}, // 4
+    {0xFC, 0xC0, 0xF8, 0x0C, 0x0C, 0x0C, 0xCC, 0x78}, // 5
+    {0x78, 0xC0, 0xC0, 0xF8, 0xCC, 0xCC, 0xCC, 0x78}, // 6
+    {0xFC, 0x0C, 0x18, 0x30, 0x30, 0x60, 0x60, 0x60}, // 7
+    {0x78, 0xCC, 0xCC, 0x78, 0xCC, 0xCC, 0xCC, 0x78}, // 8
+    {0x78, 0xCC, 0xCC, 0xCC, 0x7C, 0x0C, 0x0C, 0x78}, // 9
+};
+
+constexpr GFXdigitFont Digits3x5 = makeDigitFont(3, 5, 4, Digits3x5Glyphs);
+constexpr GFXdigitFont Digits4x7 = makeDigitFont(4, 7, 5, Digits4x7Glyphs);
+constexpr GFXdigitFont Digits5x7Bold =
+    makeDigitFont(5, 7, 6, Digits5x7BoldGlyphs);
+constexpr GFXdigitFont Digits6x8Wide =
+    makeDigitFont(6, 8, 7, Digits6x8WideGlyphs);
@@ -0,0 +1,25 @@
+// Numeral-only bitmap fonts for GFXcanvas1::drawNumber().
+// Besides the ten glyphs, every font carries the rows of all 100 two-digit
+// pairs, pre-shifted into one 16-bit word each, so a "%02d" field is drawn
+// as one masked row write per scanline, without any string formatting.
+
+#ifndef _DIGITFONT_H_
+#define _DIGITFONT_H_
+
+#include <stdint.h>
+
+/// Digit font data, glyph rows are MSB-first (leftmost pixel in bit 7)
+typedef struct {
+  uint8_t width;          ///< Glyph width in pixels (at most 7)
+  uint8_t height;         ///< Glyph height in pixels (at most 8)
+  uint8_t xAdvance;       ///< Distance to advance cursor per digit (x axis)
+  uint8_t glyph[10][8];   ///< Rows of the digits 0-9
+  uint16_t pair[100][8];  ///< Rows of 00-99, tens digit from bit 15
+} GFXdigitFont;
+
+extern const GFXdigitFont Digits3x5;     ///< 3x5, advance 4
+extern const GFXdigitFont Digits4x7;     ///< 4x7, advance 5
+extern const GFXdigitFont Digits5x7Bold; ///< 5x7 with 2 pixel strokes, adv. 6
+extern const GFXdigitFont Digits6x8Wide; ///< 6x8 with 2 pixel strokes, adv. 7
+
+#endif // _DIGITFONT_H_
@@ -0,0 +1,139 @@
+// Interface for fonts covering more than the 8-bit character sets, e.g. a
+// CJK font image in flash. Pass one to Adafruit_GFX::setUnicodeFont() and
+// print() / write() take UTF-8 and draw each code point through it.
+
+#ifndef _UNICODEFONT_H_
+#define _UNICODEFONT_H_
+
+#include <stdint.h>
+
+/// One glyph handed out by a GFXunicodeFont
+typedef struct {
+  const uint8_t *bitmap; ///< height rows of (width + 7) / 8 bytes, MSB-first
+  uint8_t width;         ///< Bitmap dimensions in pixels
+  uint8_t height;        ///< Bitmap dimensions in pixels
+  uint8_t xAdvance;      ///< Distance to advance cursor (x axis)
+} GFXunicodeGlyph;
+
+/// Glyph source for Unicode text, bitmaps are drawn from the cursor
+/// position as their top left corner
+class GFXunicodeFont {
+public:
+  virtual ~GFXunicodeFont() {}
+
+  /**********************************************************************/
+  /*!
+    @brief    Look up a code point
+    @param    codepoint  Unicode scalar value
+    @param    glyph      Filled in on success; the bitmap stays valid at
+                         least until the next getGlyph() call
+    @returns  False if the font has no such glyph
+  */
+  /**********************************************************************/
+  virtual bool getGlyph(uint32_t codepoint, GFXunicodeGlyph *glyph) = 0;
+
+  /**********************************************************************/
+  /*!
+    @brief    Get the line height
+    @returns  Newline distance (y axis) in pixels
+  */
+  /**********************************************************************/
+  virtual uint8_t yAdvance(void) const = 0;
+};
+
+/// Incremental UTF-8 decoder shared by write() and the text measuring code,
+/// so both see the same code points. Only well-formed UTF-8 is accepted:
+/// overlong forms, surrogates and code points past U+10FFFF are rejected.
+/// Every invalid or truncated sequence comes out as one U+FFFD.
+class GFXutf8Decoder {
+public:
+  /// Result of decode()
+  enum Result {
+    NEED_MORE = 0, ///< Byte taken, the sequence goes on
+    DONE,          ///< Byte taken, codepoint set
+    AGAIN          ///< codepoint is U+FFFD for a cut off sequence, the byte
+                   ///< was not taken and must be decoded again
+  };
+
+  GFXutf8Decoder(void) { reset(); }
+
+  /**********************************************************************/
+  /*!
+    @brief  Drop any partial sequence
+  */
+  /**********************************************************************/
+  void reset(void) {
+    _code = 0;
+    _need = 0;
+  }
+
+  /**********************************************************************/
+  /*!
+    @brief    Feed one byte of UTF-8 text
+    @param    c          The next byte of text
+    @param    codepoint  Set to the decoded code point for DONE and AGAIN
+    @returns  What became of the byte, see Result
+  */
+  /**********************************************************************/
+  Result decode(uint8_t c, uint32_t *codepoint) {
+    if (_need) {
+      if (c < _lower || c > _upper) { // Cut off by c, which starts over
+        _need = 0;
+        *codepoint = 0xFFFD;
+        return AGAIN;
+      }
+      _code = (_code << 6) | (c & 0x3F);
+      _lower = 0x80;
+      _upper = 0xBF;
+      if (--_need)
+        return NEED_MORE;
+      *codepoint = _code;
+      return DONE;
+    }
+    if (c < 0x80) {
+      *codepoint = c;
+      return DONE;
+    }
+    if (c < 0xC2 || c > 0xF4) { // Stray continuation, overlong or too big
+      *codepoint = 0xFFFD;
+      return DONE;
+    }
+    // The second byte range rules out overlong forms, surrogates (ED A0 -
+    // ED BF) and code points past U+10FFFF (F4 90 - F4 BF)
+    _lower = c == 0xE0 ? 0xA0 : c == 0xF0 ? 0x90 : 0x80;
+    _upper = c == 0xED ? 0x9F : c == 0xF4 ? 0x8F : 0xBF;
+    _need = c < 0xE0 ? 1 : c < 0xF0 ? 2 : 3;
+    _code = c & (0x3F >> _need);
+    return NEED_MORE;
+  }
+
+  /**********************************************************************/
+  /*!
+    @brief    Decode the next code point of a NUL terminated string, as
+              write() would given the same bytes; a sequence cut off by
+              the end of the string comes out as U+FFFD
+    @param    text  The string, moved past the code point
+    @returns  The code point
+  */
+  /**********************************************************************/
+  static uint32_t next(const char *&text) {
+    GFXutf8Decoder decoder;
+    uint32_t codepoint = 0xFFFD;
+    while (*text || !decoder._need) {
+      Result result = decoder.decode((uint8_t)*text, &codepoint);
+      if (result != AGAIN)
+        text++;
+      if (result != NEED_MORE)
+        break;
+    }
+    return codepoint;
+  }
+
+private:
+  uint32_t _code; ///< Code point bits of a partial sequence
+  uint8_t _need;  ///< Continuation bytes still expected
+  uint8_t _lower; ///< Lowest byte accepted as the next continuation
+  uint8_t _upper; ///< Highest byte accepted as the next continuation
+};
+
+#endif // _UNICODEFONT_H_
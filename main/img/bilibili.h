@@ -1,9 +1,11 @@
 #pragma once
 
+#include "gfx/bitmapbake.h"
+
 #define bili_tv_width  8
 #define bili_tv_height 8
 
-const uint8_t bili_tv_data1[] = {
+static constexpr uint8_t bili_tv_src1[] = {
   0b10000001,
   0b01000010,
   0b01111110,
@@ -14,7 +16,7 @@ const uint8_t bili_tv_data1[] = {
   0b01111110,
 };
 
-const uint8_t bili_tv_data2[] = {
+static constexpr uint8_t bili_tv_src2[] = {
   0b00000000,
   0b10000001,
   0b01111110,
@@ -24,3 +26,12 @@ const uint8_t bili_tv_data2[] = {
   0b10000001,
   0b01111110,
 };
+
+// Canvas row format, converted by the compiler
+static constexpr auto bili_tv_data1 = gfxBakeRows<bili_tv_width, bili_tv_height>(bili_tv_src1);
+static constexpr auto bili_tv_data2 = gfxBakeRows<bili_tv_width, bili_tv_height>(bili_tv_src2);
+
+// Both frames as a DeltaAnimation, one second each
+static constexpr GFXbitmap<bili_tv_width, bili_tv_height> bili_tv_frames[] = {bili_tv_data1, bili_tv_data2};
+static constexpr uint16_t bili_tv_frame_ms[] = {1000, 1000};
+static constexpr auto bili_tv_anim = gfxBakeDelta<gfxDeltaSize(bili_tv_frames, bili_tv_frame_ms)>(bili_tv_frames, bili_tv_frame_ms);
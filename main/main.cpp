@@ -10,9 +10,18 @@
 #include "EventLoop.h"
 #include "adc/adc_dma.h"
 #include "adc/fft.h"
+#include "asset/AssetPack.h"
 #include "esp_misc.h"
+#include "font/FontStore.h"
+#include "font/MappedRegion.h"
+#include "game/Games.h"
 #include "img/bilibili.h"
+#include "matrix/DeltaAnimation.h"
+#include "matrix/Effects.h"
 #include "matrix/LEDCanvas.h"
+#include "matrix/LayerCompositor.h"
+#include "matrix/LifeAutomaton.h"
+#include "matrix/ScreenTransition.h"
 #include "utils/IntervalCall.hpp"
 #include "wifi/smartconfig.h"
 #include "wifi/sntp.h"
@@ -38,8 +47,11 @@ enum class TimeSettingType {
 enum class DeviceShowType {
   kTime,
   kMusic,
+  kLife,
+  kEffect,
+  kGame,
 };
-#define DeviceShowTypeNum 2
+#define DeviceShowTypeNum 5
 
 #define BUTTON_UP GPIO_NUM_1    // 时间+
 #define BUTTON_DOWN GPIO_NUM_2  // 时间-
@@ -56,8 +68,12 @@ const static char* TAG = "MAIN";
 const static char* NS_NAME_WIFI = "wifi";
 const static char* NS_NAME_MISC = "misc";
 
-static std::shared_ptr<LedMatrix> ledMatrix;
-static std::shared_ptr<LEDCanvas> ledCanvas;
+// display stack, statically allocated in app_main() / config_time_layers()
+static LEDCanvas* ledCanvas;
+static LayerCompositor* timeLayers;
+static DeltaAnimation tvAnimation;  // "bili_tv" of the assets partition, or the built-in frames
+static ScreenTransition screenTransition(32, 16, esp_random());  // from one DeviceShowType to the next
+static GameRuntime gameRuntime;  // the game screen, its state lives in the runtime's arena
 static EventLoop eventLoop;
 static QueueHandle_t gpioEvtQueue = xQueueCreate(8, 1);
 
@@ -108,7 +124,7 @@ static void show_loading() {
   ledCanvas->fillScreen(0);
   ledCanvas->setCursor(0, 1);
   ledCanvas->print("BILI");
-  ledCanvas->drawBitmap(24, 0, bili_tv_data1, bili_tv_width, bili_tv_height, 1);
+  ledCanvas->drawBitmap(24, 0, bili_tv_data1.rows[0], bili_tv_width, bili_tv_height, 1);
   ledCanvas->display();
 
   // show loading for 2 second
@@ -122,7 +138,7 @@ static void show_loading() {
 
 static void config_button() {
   ESP_ERROR_CHECK(gpio_install_isr_service(0));
-  gpio_num_t gpio_pins[] = {BUTTON_FUN};
+  gpio_num_t gpio_pins[] = {BUTTON_UP, BUTTON_DOWN, BUTTON_SET, BUTTON_SW, BUTTON_FUN};
 
   for (auto pin : gpio_pins) {
     gpio_config_t io_conf = {
@@ -153,10 +169,40 @@ static void config_button() {
   }
 }
 
-static void check_button() {
-  uint8_t pin;
-  if (!xQueueReceive(gpioEvtQueue, &pin, 0)) return;
+// the game screen takes every button but BUTTON_FUN
+static uint8_t game_button(uint8_t pin) {
+  switch (pin) {
+    case BUTTON_UP:
+      return kButtonUp;
+    case BUTTON_DOWN:
+      return kButtonDown;
+    case BUTTON_SET:
+      return kButtonLeft;
+    case BUTTON_SW:
+      return kButtonRight;
+    default:
+      return 0;
+  }
+}
+
+// buttons pull the pin low while held
+static uint8_t read_game_buttons() {
+  uint8_t held = 0;
+  for (auto pin : {BUTTON_UP, BUTTON_DOWN, BUTTON_SET, BUTTON_SW}) {
+    if (gpio_get_level(pin) == 0) held |= game_button(pin);
+  }
+  return held;
+}
+
+static void handle_button(uint8_t pin) {
   ESP_LOGI(TAG, "button: %d", pin);
+  if (deviceShowType == DeviceShowType::kGame && game_button(pin)) {
+    gameRuntime.press(game_button(pin));
+    return;
+  }
+  // the clock keys act only where their effect is on screen: the time screen, and the gain keys of the music screen
+  const bool gainKey = deviceShowType == DeviceShowType::kMusic && (pin == BUTTON_UP || pin == BUTTON_DOWN);
+  if (pin != BUTTON_FUN && deviceShowType != DeviceShowType::kTime && !gainKey) return;
   switch (pin) {
     case BUTTON_SW: {
       // switch show type
@@ -216,6 +262,9 @@ static void check_button() {
     case BUTTON_FUN: {
       static uint8_t count = 0;
       deviceShowType = static_cast<DeviceShowType>(++count % DeviceShowTypeNum);
+      // the new screen draws off-screen from now on, the panel blends over to it (a different effect each time)
+      screenTransition.start(ledCanvas, static_cast<ScreenTransition::Kind>(count % ScreenTransition::kKindNum), 16);
+      timeLayers->invalidate();
       auto nvs = nvs::open_nvs_handle(NS_NAME_MISC, NVS_READWRITE);
       nvs->set_item("show_type", deviceShowType);
     } break;
@@ -224,141 +273,177 @@ static void check_button() {
   }
 }
 
-static void update_time_ui() {
+// layers of the time screen, bottom to top
+enum TimeLayer {
+  kLayerBackground = 0,  // static glyphs: '::'
+  kLayerDigits,          // clock text, redrawn when the shown time changes
+  kLayerAnim,            // bars of the second screen
+  kLayerTv,              // small tv, decoded in place by tvAnimation
+  kLayerBlink,           // erase mask of the field being set
+};
+
+static void config_time_layers() {
+  static LayerCompositor compositor(32, 16);
+  static GFXstaticCanvas1<32, 16> layers[5];
+  timeLayers = &compositor;
+  timeLayers->addLayer(LayerCompositor::BlendOp::kOr, &layers[kLayerBackground]);
+  timeLayers->addLayer(LayerCompositor::BlendOp::kOr, &layers[kLayerDigits]);
+  timeLayers->addLayer(LayerCompositor::BlendOp::kOr, &layers[kLayerAnim]);
+  timeLayers->addLayer(LayerCompositor::BlendOp::kOr, &layers[kLayerTv]);
+  timeLayers->addLayer(LayerCompositor::BlendOp::kAndNot, &layers[kLayerBlink]);
+
+  auto background = timeLayers->layer(kLayerBackground);
+  background->fillRect(15, 2, 2, 2, 1);
+  background->fillRect(15, 5, 2, 2, 1);
+  timeLayers->markDirty(kLayerBackground);
+
+  tvAnimation.attach(timeLayers->layer(kLayerTv), 0, 8);
+}
+
+static bool update_time_ui(GFXcanvas1* target) {
   tm* time_now;
   /// get time
+  time_t timer;
   {
-    time_t timer;
     time(&timer);
     time_now = localtime(&timer);
   }
 
-  ledCanvas->fillScreen(0);
+  // the field being set selects what the bottom shows, and blinks
+  BottomShowType bottomType = bottomShowType;
+  switch (timeSettingType) {
+    case TimeSettingType::kYear:
+      bottomType = BottomShowType::kYear;
+      break;
+    case TimeSettingType::kMon:
+    case TimeSettingType::kDay:
+      bottomType = BottomShowType::kMon;
+      break;
+    default:
+      break;
+  }
 
-  /// up screen
+  /// '::'
   {
-    char time_str[8];
-    // hour
-    sprintf(time_str, "%02d", time_now->tm_hour);
-    ledCanvas->setCursor(2, 1);
-    ledCanvas->print(time_str);
-    // '::'
     static bool showPoint;
     static IntervalCall intervalCall(std::chrono::milliseconds(500), [] { showPoint = !showPoint; });
     intervalCall.poll();
-    if (showPoint) {
-      ledCanvas->drawPixel(15, 2, 1);
-      ledCanvas->drawPixel(16, 2, 1);
-      ledCanvas->drawPixel(15, 3, 1);
-      ledCanvas->drawPixel(16, 3, 1);
-      ledCanvas->drawPixel(15, 5, 1);
-      ledCanvas->drawPixel(16, 5, 1);
-      ledCanvas->drawPixel(15, 6, 1);
-      ledCanvas->drawPixel(16, 6, 1);
-    }
-    // min
-    sprintf(time_str, "%02d", time_now->tm_min);
-    ledCanvas->setCursor(19, 1);
-    ledCanvas->print(time_str);
+    timeLayers->setVisible(kLayerBackground, showPoint);
   }
-  /// bottom screen
-  auto bottom_show_second = [&] {
-    // small tv animation
-    auto tv_data = time_now->tm_sec % 2 ? bili_tv_data1 : bili_tv_data2;
-    ledCanvas->drawBitmap(0, 8, tv_data, bili_tv_width, bili_tv_height, 1);
 
-    // diy animation
-    static uint8_t array[]{};
-    static IntervalCall intervalCall(std::chrono::milliseconds(300), [] {
-      for (int i = 0; i < 9; ++i) {
-        array[i] = esp_random() % 8;
-      }
-    });
-    intervalCall.poll();
-    for (int i = 0; i < 9; ++i) {
-      ledCanvas->drawLine(9 + i, 15, 9 + i, 15 - array[i], 1);
-    }
+  /// clock text
+  static time_t lastTimer = -1;
+  static BottomShowType lastBottomType;
+  if (timer != lastTimer || bottomType != lastBottomType) {
+    auto canvas = timeLayers->layer(kLayerDigits);
+    canvas->fillScreen(0);
 
-    // second display
-    ledCanvas->setCursor(19, 9);
-    char time_str[8];
-    sprintf(time_str, "%02d", time_now->tm_sec);
-    ledCanvas->print(time_str);
-  };
-  auto bottom_show_year = [&time_now] {
-    char time_str[14];
-    // 2020
-    sprintf(time_str, "%d Y", 1900 + time_now->tm_year);
-    ledCanvas->setCursor(2, 9);
-    ledCanvas->print(time_str);
-  };
-  auto bottom_show_mon = [&time_now] {
-    char time_str[8];
-    // 02-18
-    sprintf(time_str, "%02d-%02d", time_now->tm_mon, time_now->tm_mday);
-    ledCanvas->setCursor(2, 9);
-    ledCanvas->print(time_str);
-  };
+    // hour
+    canvas->setCursor(2, 1);
+    canvas->drawNumber(time_now->tm_hour, 2, &Digits5x7Bold);
+    // min
+    canvas->setCursor(19, 1);
+    canvas->drawNumber(time_now->tm_min, 2, &Digits5x7Bold);
 
-  auto show_user_set_type = [&] {
-    switch (bottomShowType) {
+    switch (bottomType) {
       case BottomShowType::kSecond:
-        bottom_show_second();
+        canvas->setCursor(19, 9);
+        canvas->drawNumber(time_now->tm_sec, 2, &Digits5x7Bold);
         break;
       case BottomShowType::kYear:
-        bottom_show_year();
+        // 2020
+        canvas->setCursor(2, 9);
+        canvas->printNumber(1900 + time_now->tm_year);
+        canvas->print(" Y");
         break;
       case BottomShowType::kMon:
-        bottom_show_mon();
+        // 02-18
+        canvas->setCursor(2, 9);
+        canvas->printNumber(time_now->tm_mon, 2);
+        canvas->print("-");
+        canvas->printNumber(time_now->tm_mday, 2);
         break;
     }
-  };
-  if (timeSettingType == TimeSettingType::kNone) {
-    show_user_set_type();
-  } else {
-    // show settings
+    timeLayers->markDirty(kLayerDigits);
+  }
+
+  /// animation of the second screen
+  timeLayers->setVisible(kLayerAnim, bottomType == BottomShowType::kSecond);
+  timeLayers->setVisible(kLayerTv, bottomType == BottomShowType::kSecond);
+  {
+    // the tv keeps its own frame clock, paused while hidden
+    static auto lastTick = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTick).count();
+    lastTick = now;
+    if (bottomType == BottomShowType::kSecond && tvAnimation.tick(elapsed)) {
+      timeLayers->markDirty(kLayerTv);
+    }
+  }
+  if (bottomType == BottomShowType::kSecond) {
+    // diy animation
+    static uint8_t array[9]{};
+    static bool arrayChanged;
+    static IntervalCall intervalCall(std::chrono::milliseconds(300), [] {
+      for (auto& item : array) {
+        item = esp_random() % 8;
+      }
+      arrayChanged = true;
+    });
+    intervalCall.poll();
+
+    if (arrayChanged || timer != lastTimer) {
+      arrayChanged = false;
+      auto canvas = timeLayers->layer(kLayerAnim);
+      canvas->fillScreen(0);
+      for (int i = 0; i < 9; ++i) {
+        canvas->drawLine(9 + i, 15, 9 + i, 15 - array[i], 1);
+      }
+      timeLayers->markDirty(kLayerAnim);
+    }
+  }
+  lastTimer = timer;
+  lastBottomType = bottomType;
+
+  /// blink the field being set
+  {
     static bool off = false;
     static IntervalCall intervalCall(std::chrono::milliseconds(300), [] { off = !off; });
     intervalCall.poll();
-    switch (timeSettingType) {
-      case TimeSettingType::kYear:
-        if (!off) {
-          bottom_show_year();
-        }
-        break;
-      case TimeSettingType::kMon:
-        bottom_show_mon();
-        if (off) {
-          ledCanvas->fillRect(0, 9, 14, 8, 0);
-        }
-        break;
-      case TimeSettingType::kDay:
-        bottom_show_mon();
-        if (off) {
-          ledCanvas->fillRect(19, 9, 13, 8, 0);
-        }
-        break;
-      case TimeSettingType::kHour:
-        show_user_set_type();
-        if (off) {
-          ledCanvas->fillRect(0, 0, 15, 8, 0);
-        }
-        break;
-      case TimeSettingType::kMin:
-        show_user_set_type();
-        if (off) {
-          ledCanvas->fillRect(17, 0, 14, 8, 0);
-        }
-        break;
-      case TimeSettingType::kNone:
-        break;
+
+    static TimeSettingType lastSettingType = TimeSettingType::kNone;
+    if (timeSettingType != lastSettingType) {
+      lastSettingType = timeSettingType;
+      auto canvas = timeLayers->layer(kLayerBlink);
+      canvas->fillScreen(0);
+      switch (timeSettingType) {
+        case TimeSettingType::kYear:
+          canvas->fillRect(0, 8, 32, 8, 1);
+          break;
+        case TimeSettingType::kMon:
+          canvas->fillRect(0, 9, 14, 8, 1);
+          break;
+        case TimeSettingType::kDay:
+          canvas->fillRect(19, 9, 13, 8, 1);
+          break;
+        case TimeSettingType::kHour:
+          canvas->fillRect(0, 0, 15, 8, 1);
+          break;
+        case TimeSettingType::kMin:
+          canvas->fillRect(17, 0, 14, 8, 1);
+          break;
+        case TimeSettingType::kNone:
+          break;
+      }
+      timeLayers->markDirty(kLayerBlink);
     }
+    timeLayers->setVisible(kLayerBlink, off && timeSettingType != TimeSettingType::kNone);
   }
 
-  ledCanvas->display();
+  return timeLayers->compose(target);
 }
 
-static void show_music() {
+static bool show_music(GFXcanvas1* canvas) {
   const uint16_t Sn = adc->getSn();
   auto& data = adc->readData();
   // FFT计算频谱
@@ -376,7 +461,7 @@ static void show_music() {
     pointsAmp[i] = (float)fft_cal_amp(fftResult[i], Sn);
   }
 
-  ledCanvas->fillScreen(0);
+  canvas->fillScreen(0);
   const int showNumMax = 32;
   static std::vector<uint8_t> amLast;
   amLast.resize(showNumMax);
@@ -389,7 +474,7 @@ static void show_music() {
       amLast[i] = v;
     }
     am[i] = v;
-    ledCanvas->drawLine(i, 16, i, 16 - am[i], 1);
+    canvas->drawLine(i, 16, i, 16 - am[i], 1);
   }
 
   // 落下特效
@@ -402,10 +487,80 @@ static void show_music() {
   });
   intervalCall.poll();
   for (int i = 0; i < showNumMax; ++i) {
-    ledCanvas->drawPixel(i, 16 - amLast[i], 1);
+    canvas->drawPixel(i, 16 - amLast[i], 1);
   }
 
-  ledCanvas->display();
+  return true;
+}
+
+static bool show_life(GFXcanvas1* canvas) {
+  static LifeAutomaton life(32, 16);
+  static IntervalCall intervalCall(std::chrono::milliseconds(150));
+  if (!intervalCall.poll()) return false;
+
+  // reseed once the board dies out, freezes or blinks
+  if (!life.step() || life.generation() > 2000) {
+    life.randomize(esp_random(), 35);
+  }
+  life.render(canvas);
+  return true;
+}
+
+static bool show_effect(GFXcanvas1* canvas) {
+  static RainEffect rain(32, 16, esp_random());
+  static StarfieldEffect starfield(32, 16, esp_random());
+  static PlasmaEffect plasma(32, 16, esp_random());
+  static RippleEffect ripple(32, 16, esp_random());
+  static FireEffect fire(32, 16, esp_random());
+  static Effect* const effects[] = {&rain, &starfield, &plasma, &ripple, &fire};
+  static uint8_t index = 0;
+  static IntervalCall nextEffect(std::chrono::seconds(30), [] { index = (index + 1) % (sizeof(effects) / sizeof(effects[0])); });
+  static IntervalCall frame(std::chrono::milliseconds(40));
+  if (!frame.poll()) return false;
+  nextEffect.poll();
+
+  static auto lastTick = std::chrono::steady_clock::now();
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTick).count();
+  lastTick = now;
+  effects[index]->step(elapsed);
+  effects[index]->render(canvas);
+  return true;
+}
+
+static void start_game(uint8_t index) {
+  switch (index % 2) {
+    case 0:
+      gameRuntime.start<SnakeGame>(32, 16, esp_random());
+      break;
+    case 1:
+      gameRuntime.start<BreakoutGame>(32, 16, esp_random());
+      break;
+  }
+}
+
+static bool show_game(GFXcanvas1* canvas) {
+  static uint8_t index = 0;
+  static auto lastTick = std::chrono::steady_clock::now();
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTick).count();
+  lastTick = now;
+
+  bool changed = false;
+  if (!gameRuntime.game()) {
+    start_game(index);
+    changed = true;
+  } else {
+    changed = gameRuntime.advance(elapsed, read_game_buttons());
+  }
+  // Down on the game over screen
+  if (gameRuntime.takeNextRequest()) {
+    start_game(++index);
+    changed = true;
+  }
+  // drawn every time (it is cheap), a transition's incoming canvas starts out stale
+  gameRuntime.game()->render(canvas);
+  return changed;
 }
 
 static void config_music() {
@@ -417,14 +572,63 @@ static void config_music() {
 }
 
 
-static void refresh_ui() {
+// no screen draws CJK text yet: the font image is only checked and reported, a screen that does would
+// setUnicodeFont(&store) on its canvas
+static void config_font() {
+  static MappedRegion region;
+  static FontStore store;
+  if (region.mapPartition("font") && store.load(region.data(), region.size())) {
+    ESP_LOGI(TAG, "font: %u glyphs", (unsigned)store.glyphCount());
+  } else {
+    ESP_LOGW(TAG, "font: no font image, flash one built by tools/mkfont.py");
+    region.unmap();
+  }
+}
+
+static void config_assets() {
+  static MappedRegion region;
+  static AssetPack pack;
+  AssetPack::Asset tv;
+  if (region.mapPartition("assets") && pack.load(region.data(), region.size())) {
+    ESP_LOGI(TAG, "assets: %u", pack.assetCount());
+  } else {
+    ESP_LOGW(TAG, "assets: no asset pack, flash one built by tools/mkassets.py");
+    region.unmap();
+  }
+  if (!pack.find("bili_tv", &tv) || tv.type != AssetPack::Type::kAnimation || !tvAnimation.load(tv.data, tv.size)) {
+    tvAnimation.load(bili_tv_anim.data, sizeof(bili_tv_anim.data));
+  }
+}
+
+/* Draw the current screen into canvas, returns false if it did not change */
+static bool draw_screen(GFXcanvas1* canvas) {
   switch (deviceShowType) {
     case DeviceShowType::kTime:
-      update_time_ui();
-      break;
+      return update_time_ui(canvas);
     case DeviceShowType::kMusic:
-      show_music();
-      break;
+      return show_music(canvas);
+    case DeviceShowType::kLife:
+      return show_life(canvas);
+    case DeviceShowType::kEffect:
+      return show_effect(canvas);
+    case DeviceShowType::kGame:
+      return show_game(canvas);
+  }
+  return false;
+}
+
+static void refresh_ui() {
+  if (!screenTransition.running()) {
+    if (draw_screen(ledCanvas)) {
+      ledCanvas->display();
+    }
+    return;
+  }
+  // the incoming screen keeps running behind the transition; once it ends the panel holds its last frame
+  draw_screen(screenTransition.incoming());
+  static IntervalCall frame(std::chrono::milliseconds(30));
+  if (frame.poll() && screenTransition.nextFrame(ledCanvas)) {
+    ledCanvas->display();
   }
 }
 
@@ -437,20 +641,31 @@ extern "C" void app_main() {
   config_button();
   config_music();
 
-  ledMatrix = std::make_shared<LedMatrix>(GPIO_NUM_8, GPIO_NUM_6, GPIO_NUM_7, 8);
+  static LedMatrix ledMatrix(GPIO_NUM_8, GPIO_NUM_6, GPIO_NUM_7, 8);
   for (int i = 0; i < 8; i++) {
-    ledMatrix->shutdown(i, false);
-    ledMatrix->setIntensity(i, 1);
-    ledMatrix->clearDisplay(i);
+    ledMatrix.shutdown(i, false);
+    ledMatrix.setIntensity(i, 1);
+    ledMatrix.clearDisplay(i);
   }
 
-  ledCanvas = std::make_shared<LEDCanvas>(ledMatrix, 32, 16);
+  static StaticLEDCanvas<32, 16> canvas(ledMatrix);
+  ledCanvas = &canvas;
   show_loading();
+  config_font();
+  config_assets();
+  config_time_layers();
 
   for (;;) {
+    // sleep until a button or the next frame: a game tick is due at its own time, and a press is handled (and
+    // drawn) at once instead of waiting for the next 10 ms poll
+    uint32_t waitMs = deviceShowType == DeviceShowType::kGame ? gameRuntime.msUntilNextTick() : 10;
+    TickType_t waitTicks = pdMS_TO_TICKS(waitMs);
+    if (waitMs && !waitTicks) waitTicks = 1;
+    uint8_t pin;
+    if (xQueueReceive(gpioEvtQueue, &pin, waitTicks)) {
+      handle_button(pin);
+    }
     eventLoop.poll();
-    check_button();
     refresh_ui();
-    delay_ms(10);
   }
 }
@@ -0,0 +1,80 @@
+#include "Bitboard.h"
+
+#include <cstring>
+
+Bitboard::Bitboard(uint8_t w, uint8_t h) {
+  width_ = w < 1 ? 1 : w > kMaxSize ? kMaxSize : w;
+  height_ = h < 1 ? 1 : h > kMaxSize ? kMaxSize : h;
+  mask_ = ~0u << (32 - width_);
+}
+
+void Bitboard::clear() { memset(rows_, 0, sizeof(rows_)); }
+
+uint32_t Bitboard::span(int16_t x, int16_t w) const {
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (w <= 0 || x >= width_) return 0;
+  if (w > 32) w = 32;
+  return ((w == 32 ? ~0u : ~(~0u >> w)) >> x) & mask_;
+}
+
+void Bitboard::set(int16_t x, int16_t y, bool on) { fillRect(x, y, 1, 1, on); }
+
+bool Bitboard::test(int16_t x, int16_t y) const {
+  return x >= 0 && x < width_ && y >= 0 && y < height_ && (rows_[y] << x) >> 31;
+}
+
+void Bitboard::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on) {
+  const uint32_t bits = span(x, w);
+  for (int16_t j = y < 0 ? 0 : y; j < y + h && j < height_; ++j) {
+    if (on) {
+      rows_[j] |= bits;
+    } else {
+      rows_[j] &= ~bits;
+    }
+  }
+}
+
+bool Bitboard::intersectsRect(int16_t x, int16_t y, int16_t w, int16_t h) const {
+  const uint32_t bits = span(x, w);
+  for (int16_t j = y < 0 ? 0 : y; j < y + h && j < height_; ++j) {
+    if (rows_[j] & bits) return true;
+  }
+  return false;
+}
+
+bool Bitboard::intersects(const Bitboard& other, int16_t dx, int16_t dy) const {
+  if (dx <= -32 || dx >= 32) return false;
+  for (int16_t j = dy < 0 ? 0 : dy; j < dy + other.height_ && j < height_; ++j) {
+    const uint32_t moved = dx >= 0 ? other.rows_[j - dy] >> dx : other.rows_[j - dy] << -dx;
+    if (rows_[j] & moved) return true;
+  }
+  return false;
+}
+
+uint16_t Bitboard::count() const {
+  uint16_t n = 0;
+  for (uint8_t y = 0; y < height_; ++y) {
+    for (uint32_t row = rows_[y]; row; row &= row - 1) ++n;
+  }
+  return n;
+}
+
+void Bitboard::load(const GFXcanvas1* canvas) {
+  clear();
+  const int16_t stride = canvas->getRowBytes();
+  const int16_t bytes = stride < 4 ? stride : 4;
+  const uint8_t rows = canvas->height() < height_ ? canvas->height() : height_;
+  const uint32_t mask = canvas->width() < width_ ? mask_ & (~0u << (32 - canvas->width())) : mask_;
+  for (uint8_t y = 0; y < rows; ++y) rows_[y] = gfxRowWord(canvas->getBuffer() + y * stride, bytes) & mask;
+}
+
+void Bitboard::render(GFXcanvas1* canvas, bool opaque) const {
+  if (opaque) {
+    canvas->drawBitmap(0, 0, rows_, width_, height_, 1, 0);
+  } else {
+    canvas->drawBitmap(0, 0, rows_, width_, height_, 1);
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * Board of up to 32x32 cells, one 32-bit word per row (leftmost cell in bit 31, as the canvas stores it): a Life
+ * generation, walls, a snake's body. Collision tests run on whole row words, a rectangle or another board is one
+ * AND per row. Cells outside the board read as empty.
+ */
+class Bitboard {
+ public:
+  static const int kMaxSize = 32;
+
+  /* w and h are clamped to 1 - kMaxSize */
+  Bitboard(uint8_t w, uint8_t h);
+
+  uint8_t width() const { return width_; }
+  uint8_t height() const { return height_; }
+  /* The width() cells of a row */
+  uint32_t rowMask() const { return mask_; }
+
+  void clear();
+  void set(int16_t x, int16_t y, bool on = true);
+  bool test(int16_t x, int16_t y) const;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool on);
+
+  /* Any cell set in the rectangle */
+  bool intersectsRect(int16_t x, int16_t y, int16_t w, int16_t h) const;
+
+  /* Any cell set in both boards, with other moved by dx, dy */
+  bool intersects(const Bitboard& other, int16_t dx = 0, int16_t dy = 0) const;
+
+  /* Number of cells set */
+  uint16_t count() const;
+
+  uint32_t row(uint8_t y) const { return y < height_ ? rows_[y] : 0; }
+  /* Replace row y, cells beyond the width are dropped */
+  void setRow(uint8_t y, uint32_t bits) {
+    if (y < height_) rows_[y] = bits & mask_;
+  }
+  /* The height() row words */
+  const uint32_t* rows() const { return rows_; }
+
+  /* Take the board from the top left of canvas (not rotated), the cells beyond it are cleared */
+  void load(const GFXcanvas1* canvas);
+
+  /* Draw the board to canvas, cell x, y on pixel x, y: set cells lit, the others kept, or cleared if opaque */
+  void render(GFXcanvas1* canvas, bool opaque = false) const;
+
+ private:
+  /* cells x to x + w - 1 of a row, clipped to the board */
+  uint32_t span(int16_t x, int16_t w) const;
+
+  uint8_t width_;
+  uint8_t height_;
+  uint32_t mask_;  // the width_ cells of a row
+  uint32_t rows_[kMaxSize] = {};
+};
@@ -0,0 +1,142 @@
+#include "DeltaAnimation.h"
+
+#include "utils/LittleEndian.hpp"
+
+static const size_t kHeaderSize = 8;
+static const size_t kRecordHeaderSize = 4;
+
+static const uint8_t* nextRecord(const uint8_t* record) { return record + kRecordHeaderSize + readU16(record + 2); }
+
+bool DeltaAnimation::load(const uint8_t* data, size_t size) {
+  first_ = loopRecord_ = nullptr;
+  canvas_ = nullptr;
+  count_ = 0;
+  if (!data || size < kHeaderSize) return false;
+  uint16_t width = readU16(data), height = readU16(data + 2), count = readU16(data + 4);
+  if (!width || !height || !count) return false;
+  const uint16_t rowBytes = (width + 7) / 8;
+  const uint32_t frameBytes = (uint32_t)rowBytes * height;
+  const uint8_t padMask = width % 8 ? 0xFF >> (width % 8) : 0;
+
+  // check every op once here, tick() then trusts the data: no write may leave the region
+  const uint8_t* record = data + kHeaderSize;
+  const uint8_t* end = data + size;
+  uint32_t totalMs = 0;
+  for (uint32_t i = 0; i <= count; ++i) {
+    if (end - record < (ptrdiff_t)kRecordHeaderSize) return false;
+    uint16_t ms = readU16(record);
+    if (i < count && !ms) return false;
+    totalMs += ms;
+    const uint8_t* op = record + kRecordHeaderSize;
+    const uint8_t* opEnd = nextRecord(record);
+    if (opEnd > end) return false;
+    uint32_t pos = 0;
+    while (op < opEnd) {
+      if (opEnd - op < 2) return false;
+      pos += op[0];
+      uint8_t n = op[1];
+      op += 2;
+      uint16_t run = n < 128 ? n + 1 : n > 128 ? 257 - n : 0;
+      uint16_t dataBytes = n < 128 ? run : n > 128 ? 1 : 0;
+      if (opEnd - op < dataBytes || pos + run > frameBytes) return false;
+      for (uint16_t k = 0; padMask && k < run; ++k) {
+        uint8_t v = n < 128 ? op[k] : op[0];
+        if ((pos + k) % rowBytes == rowBytes - 1u && (v & padMask)) return false;  // pixel right of the sprite
+      }
+      op += dataBytes;
+      pos += run;
+    }
+    if (i == count) loopRecord_ = record;
+    record = opEnd;
+  }
+
+  first_ = data + kHeaderSize;
+  width_ = width;
+  height_ = height;
+  count_ = count;
+  rowBytes_ = rowBytes;
+  totalMs_ = totalMs;
+  return true;
+}
+
+bool DeltaAnimation::attach(GFXcanvas1* canvas, int16_t x, int16_t y) {
+  if (!first_ || !canvas || canvas->getRotation() != 0) return false;
+  if (x < 0 || y < 0 || x + width_ > canvas->width() || y + height_ > canvas->height()) return false;
+  canvas_ = canvas;
+  x_ = x;
+  y_ = y;
+  restart();
+  return true;
+}
+
+void DeltaAnimation::restart() {
+  if (!canvas_) return;
+  canvas_->fillRawRect(x_, y_, width_, height_, 0);
+  frame_ = 0;
+  done_ = false;
+  shownMs_ = 0;
+  apply(first_);
+  durationMs_ = readU16(first_);
+  next_ = nextRecord(first_);
+}
+
+bool DeltaAnimation::tick(uint32_t elapsedMs) {
+  if (!canvas_ || done_) return false;
+  // whole loops end on the same frame: skip them instead of decoding them
+  if (loop_ && elapsedMs >= totalMs_) elapsedMs %= totalMs_;
+  shownMs_ += elapsedMs;
+
+  bool changed = false;
+  while (shownMs_ >= durationMs_) {
+    const uint8_t* record;
+    if (frame_ + 1 < count_) {
+      record = next_;
+      ++frame_;
+    } else if (loop_) {
+      record = loopRecord_;
+      frame_ = 0;
+    } else {
+      done_ = true;
+      break;
+    }
+    apply(record);
+    changed |= readU16(record + 2) != 0;
+    shownMs_ -= durationMs_;
+    // the loop record has no duration, frame 0 keeps its own
+    if (record == loopRecord_) record = first_;
+    durationMs_ = readU16(record);
+    next_ = nextRecord(record);
+  }
+  return changed;
+}
+
+void DeltaAnimation::apply(const uint8_t* record) {
+  const uint8_t* op = record + kRecordHeaderSize;
+  const uint8_t* end = nextRecord(record);
+  const int16_t stride = canvas_->getRowBytes();
+  const uint8_t shift = x_ & 7;
+  uint8_t* const region = canvas_->getBuffer() + y_ * stride + (x_ >> 3);
+
+  uint32_t pos = 0;
+  while (op < end) {
+    pos += op[0];
+    uint8_t n = op[1];
+    op += 2;
+    if (n == 128) continue;
+    uint16_t run = n < 128 ? n + 1 : 257 - n;
+    uint16_t col = pos % rowBytes_;
+    uint8_t* line = region + pos / rowBytes_ * stride;
+    pos += run;
+    for (uint16_t k = 0; k < run; ++k) {
+      uint8_t v = n < 128 ? *op++ : *op;
+      line[col] ^= v >> shift;
+      // load() made sure no lit bit is right of the sprite, so col + 1 is inside the canvas when needed
+      if (shift && (uint8_t)(v << (8 - shift))) line[col + 1] ^= v << (8 - shift);
+      if (++col == rowBytes_) {
+        col = 0;
+        line += stride;
+      }
+    }
+    if (n > 128) ++op;
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * Plays a 1-bit sprite animation stored as XOR deltas, decoding straight into a region of a canvas.
+ * Frame 0 is a delta against a blank frame (the keyframe), every other frame a delta against the one
+ * before it, and a last delta takes the last frame back to frame 0 for looping. Only the bytes that
+ * change are stored and touched, so a frame costs O(changed bytes) in flash and time.
+ * The player keeps no copy of the frame: the canvas region is the frame, nothing else may draw there.
+ *
+ * Data layout, little endian, built by tools/mkassets.py --anim or gfxBakeDelta() (gfx/bitmapbake.h):
+ *   u16 width, u16 height, u16 frame count, u16 reserved (0)
+ *   frame count + 1 records: u16 duration (ms, 0 in the loop record), u16 op bytes, ops
+ * The frame is height rows of (width + 7) / 8 bytes, MSB-first, as drawBitmap() takes. An op is a u8
+ * count of unchanged bytes to skip, then a PackBits header: n < 128 is followed by n + 1 bytes to XOR
+ * into the next bytes, n > 128 by one byte XORed into the next 257 - n bytes, n == 128 skips only.
+ */
+class DeltaAnimation {
+ public:
+  DeltaAnimation() = default;
+  DeltaAnimation(const DeltaAnimation&) = delete;
+  const DeltaAnimation& operator=(const DeltaAnimation&) = delete;
+
+  /* Use the animation at data (kept by the caller, e.g. in flash), false if it is malformed */
+  bool load(const uint8_t* data, size_t size);
+
+  /*
+   * Show the animation from frame 0 in the region with its top left corner at x, y.
+   * The region must lie inside the canvas, which must not be rotated; coordinates are those of the
+   * canvas buffer, any viewport is ignored. Returns false (nothing drawn) otherwise.
+   */
+  bool attach(GFXcanvas1* canvas, int16_t x, int16_t y);
+
+  /* Clear the region and start over from frame 0 */
+  void restart();
+
+  /* Start over after the last frame, otherwise stop on it (finished() becomes true) */
+  void setLoop(bool loop) { loop_ = loop; }
+
+  /* Advance the frame clock, returns true if the region changed */
+  bool tick(uint32_t elapsedMs);
+
+  bool finished() const { return done_; }
+
+  uint16_t width() const { return width_; }
+  uint16_t height() const { return height_; }
+  uint16_t frameCount() const { return count_; }
+  uint16_t frameIndex() const { return frame_; }
+
+ private:
+  void apply(const uint8_t* record);
+
+  const uint8_t* first_ = nullptr;  // record of frame 0, the loop record follows the last frame record
+  const uint8_t* loopRecord_ = nullptr;
+  uint16_t width_ = 0;
+  uint16_t height_ = 0;
+  uint16_t count_ = 0;
+  uint16_t rowBytes_ = 0;
+  uint32_t totalMs_ = 0;
+
+  GFXcanvas1* canvas_ = nullptr;
+  int16_t x_ = 0;
+  int16_t y_ = 0;
+
+  bool loop_ = true;
+  bool done_ = false;
+  uint16_t frame_ = 0;
+  const uint8_t* next_ = nullptr;  // record of the frame after frame_
+  uint32_t shownMs_ = 0;           // time frame_ has been shown
+  uint16_t durationMs_ = 0;
+};
@@ -0,0 +1,217 @@
+#include "Effects.h"
+
+#include <cstring>
+
+static const uint32_t kTickMs = 40;      // simulation rate of ripple and fire
+static const uint32_t kMaxStepMs = 1000;  // a longer pause does not make moving things jump further
+
+// sin() over a quarter turn, 64 steps, scaled to 127
+static const int8_t kQuarterSine[65] = {
+    0,  3,  6,  9,  12, 16, 19, 22, 25, 28, 31, 34, 37, 40,  43,  46,  49,  51,  54,  57,  60,  63,
+    65, 68, 71, 73, 76, 78, 81, 83, 85, 88, 90, 92, 94, 96,  98,  100, 102, 104, 106, 107, 109, 111,
+    112, 113, 115, 116, 117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127, 127,
+};
+
+Effect::Effect(uint8_t w, uint8_t h, uint32_t seed) : random_(seed) {
+  width_ = w < 1 ? 1 : w > kMaxSize ? kMaxSize : w;
+  height_ = h < 1 ? 1 : h > kMaxSize ? kMaxSize : h;
+}
+
+int8_t Effect::sin8(uint8_t angle) {
+  uint8_t i = angle & 63;
+  int8_t v = angle & 64 ? kQuarterSine[64 - i] : kQuarterSine[i];
+  return angle & 128 ? -v : v;
+}
+
+void Effect::writeRows(GFXcanvas1* canvas, const uint32_t* rows) const { canvas->drawBitmap(0, 0, rows, width_, height_, 1, 0); }
+
+RainEffect::RainEffect(uint8_t w, uint8_t h, uint32_t seed, uint8_t drops) : Effect(w, h, seed) {
+  count_ = drops > kMaxDrops ? kMaxDrops : drops;
+  for (uint8_t i = 0; i < count_; ++i) spawn(drops_[i], true);
+}
+
+void RainEffect::spawn(Drop& drop, bool anywhere) {
+  drop.x = random(width_);
+  drop.length = 1 + random(4);
+  drop.speed = 8 + random(24);
+  // new drops start above the top, staggered so they do not arrive together
+  int32_t y = anywhere ? (int32_t)random(height_ + drop.length) - drop.length : -(int32_t)random(height_);
+  drop.y = y * 256;
+}
+
+void RainEffect::step(uint32_t dtMs) {
+  if (dtMs > kMaxStepMs) dtMs = kMaxStepMs;
+  for (uint8_t i = 0; i < count_; ++i) {
+    Drop& drop = drops_[i];
+    drop.y += (int32_t)(drop.speed * dtMs * 256 / 1000);
+    if (drop.y >> 8 >= height_ + drop.length) spawn(drop, false);
+  }
+}
+
+void RainEffect::render(GFXcanvas1* canvas) const {
+  uint32_t rows[kMaxSize] = {};
+  for (uint8_t i = 0; i < count_; ++i) {
+    const Drop& drop = drops_[i];
+    int32_t head = drop.y >> 8;
+    for (int32_t y = head - drop.length + 1; y <= head; ++y) {
+      if (y >= 0 && y < height_) rows[y] |= 0x80000000u >> drop.x;
+    }
+  }
+  writeRows(canvas, rows);
+}
+
+StarfieldEffect::StarfieldEffect(uint8_t w, uint8_t h, uint32_t seed, uint8_t stars) : Effect(w, h, seed) {
+  count_ = stars > kMaxStars ? kMaxStars : stars;
+  for (uint8_t i = 0; i < count_; ++i) spawn(stars_[i], true);
+}
+
+void StarfieldEffect::spawn(Star& star, bool anywhere) {
+  star.x = (int8_t)(random(255) - 127);
+  star.y = (int8_t)(random(255) - 127);
+  star.z = (anywhere ? 16 + random(240) : 256) << 8;
+}
+
+void StarfieldEffect::step(uint32_t dtMs) {
+  if (dtMs > kMaxStepMs) dtMs = kMaxStepMs;
+  const int32_t dz = (int32_t)(speed_ * dtMs * 256 / 1000);
+  for (uint8_t i = 0; i < count_; ++i) {
+    Star& star = stars_[i];
+    star.z -= dz;
+    if (star.z < 256) spawn(star, false);
+  }
+}
+
+void StarfieldEffect::render(GFXcanvas1* canvas) const {
+  uint32_t rows[kMaxSize] = {};
+  const int16_t cx = width_ / 2, cy = height_ / 2;
+  for (uint8_t i = 0; i < count_; ++i) {
+    const Star& star = stars_[i];
+    int32_t depth = star.z >> 8;
+    int32_t x = cx + star.x * 16 / depth, y = cy + star.y * 16 / depth;
+    // a star that left the view is respawned by step(), until then it is not drawn
+    if (x >= 0 && x < width_ && y >= 0 && y < height_) rows[y] |= 0x80000000u >> x;
+  }
+  writeRows(canvas, rows);
+}
+
+PlasmaEffect::PlasmaEffect(uint8_t w, uint8_t h, uint32_t seed) : Effect(w, h, seed) {
+  for (auto& phase : phase_) phase = random(256) << 8;
+}
+
+void PlasmaEffect::step(uint32_t dtMs) {
+  if (dtMs > kMaxStepMs) dtMs = kMaxStepMs;
+  // the three waves move at different rates (angle units per second), so the pattern never repeats exactly
+  static const uint16_t kRate[3] = {97, 61, 131};
+  for (int i = 0; i < 3; ++i) phase_[i] += kRate[i] * dtMs * 256 / 1000;
+}
+
+void PlasmaEffect::render(GFXcanvas1* canvas) const {
+  const uint8_t p0 = phase_[0] >> 8, p1 = phase_[1] >> 8, p2 = phase_[2] >> 8;
+  int16_t columns[kMaxSize], lines[kMaxSize], diagonals[2 * kMaxSize];
+  for (uint8_t x = 0; x < width_; ++x) columns[x] = sin8(x * 11 + p0);
+  for (uint8_t y = 0; y < height_; ++y) lines[y] = sin8(y * 17 - p1);
+  for (uint8_t d = 0; d < width_ + height_; ++d) diagonals[d] = sin8(d * 7 + p2);
+
+  uint32_t rows[kMaxSize];
+  for (uint8_t y = 0; y < height_; ++y) {
+    uint32_t row = 0;
+    const int16_t base = lines[y] - threshold_;
+    for (uint8_t x = 0; x < width_; ++x) {
+      if (base + columns[x] + diagonals[x + y] > 0) row |= 0x80000000u >> x;
+    }
+    rows[y] = row;
+  }
+  writeRows(canvas, rows);
+}
+
+RippleEffect::RippleEffect(uint8_t w, uint8_t h, uint32_t seed) : Effect(w, h, seed) { memset(field_, 0, sizeof(field_)); }
+
+void RippleEffect::drop(uint8_t x, uint8_t y) {
+  if (x < width_ && y < height_) field_[current_][y * width_ + x] = -1024;
+}
+
+void RippleEffect::step(uint32_t dtMs) {
+  elapsed_ += dtMs > kMaxStepMs ? kMaxStepMs : dtMs;
+  for (; elapsed_ >= kTickMs; elapsed_ -= kTickMs) {
+    if (random(16) == 0) drop(random(width_), random(height_));
+    tick();
+  }
+}
+
+void RippleEffect::tick() {
+  // new = (sum of the 4 neighbours now) / 2 - value before, then damped; edges stay still
+  const int16_t* now = field_[current_];
+  int16_t* next = field_[current_ ^ 1];
+  const uint8_t w = width_;
+  for (uint8_t y = 0; y < height_; ++y) {
+    for (uint8_t x = 0; x < w; ++x) {
+      int i = y * w + x;
+      int32_t sum = (x > 0 ? now[i - 1] : 0) + (x + 1 < w ? now[i + 1] : 0) + (y > 0 ? now[i - w] : 0) + (y + 1 < height_ ? now[i + w] : 0);
+      int32_t v = (sum >> 1) - next[i];
+      next[i] = v - (v >> 5);
+    }
+  }
+  current_ ^= 1;
+}
+
+void RippleEffect::render(GFXcanvas1* canvas) const {
+  const int16_t* now = field_[current_];
+  uint32_t rows[kMaxSize];
+  for (uint8_t y = 0; y < height_; ++y, now += width_) {
+    uint32_t row = 0;
+    // crests are lit
+    for (uint8_t x = 0; x < width_; ++x) {
+      if (now[x] > 40) row |= 0x80000000u >> x;
+    }
+    rows[y] = row;
+  }
+  writeRows(canvas, rows);
+}
+
+FireEffect::FireEffect(uint8_t w, uint8_t h, uint32_t seed) : Effect(w, h, seed) { memset(heat_, 0, sizeof(heat_)); }
+
+void FireEffect::step(uint32_t dtMs) {
+  elapsed_ += dtMs > kMaxStepMs ? kMaxStepMs : dtMs;
+  for (; elapsed_ >= kTickMs; elapsed_ -= kTickMs) tick();
+}
+
+void FireEffect::tick() {
+  const uint8_t w = width_;
+  // flicker the two source rows below the screen
+  uint8_t* source = heat_ + height_ * w;
+  for (uint8_t x = 0; x < w; ++x) {
+    source[x] = source[x + w] = random(4) ? 160 + random(96) : 0;
+  }
+  // each cell takes the mean of the three cells below it and the one two below, minus a random cooling
+  uint32_t bits = 0;
+  uint8_t bitsLeft = 0;
+  for (uint8_t y = 0; y < height_; ++y) {
+    uint8_t* line = heat_ + y * w;
+    const uint8_t* below = line + w;
+    for (uint8_t x = 0; x < w; ++x) {
+      uint16_t sum = below[x > 0 ? x - 1 : x] + below[x] + below[x + 1 < w ? x + 1 : x] + below[x + w];
+      if (!bitsLeft) {
+        bits = nextRandom();
+        bitsLeft = 16;
+      }
+      uint8_t cooling = bits & 3;
+      bits >>= 2;
+      --bitsLeft;
+      int16_t v = (sum >> 2) - cooling * 2 - 160 / height_;
+      line[x] = v > 0 ? v : 0;
+    }
+  }
+}
+
+void FireEffect::render(GFXcanvas1* canvas) const {
+  uint32_t rows[kMaxSize];
+  for (uint8_t y = 0; y < height_; ++y) {
+    const uint8_t* line = heat_ + y * width_;
+    uint32_t row = 0;
+    for (uint8_t x = 0; x < width_; ++x) {
+      if (line[x] >= threshold_) row |= 0x80000000u >> x;
+    }
+    rows[y] = row;
+  }
+  writeRows(canvas, rows);
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+#include "utils/XorShift32.hpp"
+
+/**
+ * Procedural full-screen effects for the 1-bit panel: rain, starfield, plasma, ripple and fire.
+ * Everything is integer or fixed-point with lookup tables, no float or double (the ESP32-C3 has no FPU).
+ * An effect covers the top left width x height (up to 32x32) of the canvas it renders into and renders a whole
+ * frame: render() overwrites that area, rows are written as words.
+ *
+ * Each class notes its cost per 32x16 frame, counted in the inner loops: a few hundred simple operations
+ * is in the order of 10 us on the ESP32-C3 at 160 MHz.
+ */
+class Effect {
+ public:
+  static const int kMaxSize = 32;
+
+  /* width and height are clamped to 1 - kMaxSize; seed drives the randomness (e.g. esp_random()) */
+  Effect(uint8_t w, uint8_t h, uint32_t seed);
+  virtual ~Effect() = default;
+  Effect(const Effect&) = delete;
+  const Effect& operator=(const Effect&) = delete;
+
+  /* Advance the effect by dtMs milliseconds */
+  virtual void step(uint32_t dtMs) = 0;
+
+  /* Draw the current frame */
+  virtual void render(GFXcanvas1* canvas) const = 0;
+
+  uint8_t width() const { return width_; }
+  uint8_t height() const { return height_; }
+
+  /* sin() of angle / 256 turns, scaled to -127 - 127 */
+  static int8_t sin8(uint8_t angle);
+
+ protected:
+  uint32_t nextRandom() { return random_.next(); }
+  /* 0 - n-1 */
+  uint32_t random(uint32_t n) { return random_.below(n); }
+
+  /* Write rows (leftmost pixel in bit 31) to the effect area of canvas */
+  void writeRows(GFXcanvas1* canvas, const uint32_t* rows) const;
+
+  uint8_t width_;
+  uint8_t height_;
+
+ private:
+  XorShift32 random_;
+};
+
+/**
+ * Falling drops of 1-4 pixels with their own speed, "digital rain".
+ * Cost per frame: step 2 multiplies per drop, render one OR per lit pixel.
+ */
+class RainEffect : public Effect {
+ public:
+  static const int kMaxDrops = 24;
+
+  RainEffect(uint8_t w, uint8_t h, uint32_t seed, uint8_t drops = 12);
+
+  void step(uint32_t dtMs) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  struct Drop {
+    uint8_t x;
+    uint8_t length;
+    uint16_t speed;  // pixels per second
+    int32_t y;       // head, 24.8 fixed point
+  };
+
+  void spawn(Drop& drop, bool anywhere);
+
+  uint8_t count_;
+  Drop drops_[kMaxDrops];
+};
+
+/**
+ * Stars flying towards the viewer from the center, perspective-projected.
+ * Cost per frame: step one multiply per star, render two divides per star.
+ */
+class StarfieldEffect : public Effect {
+ public:
+  static const int kMaxStars = 32;
+
+  StarfieldEffect(uint8_t w, uint8_t h, uint32_t seed, uint8_t stars = 20);
+
+  /* Depth units per second, the whole depth is 256 */
+  void setSpeed(uint16_t speed) { speed_ = speed; }
+
+  void step(uint32_t dtMs) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  struct Star {
+    int8_t x;   // position across the view, projected to x * 16 / depth pixels from the center
+    int8_t y;
+    int32_t z;  // depth, 24.8 fixed point, 1 - 256
+  };
+
+  void spawn(Star& star, bool anywhere);
+
+  uint8_t count_;
+  uint16_t speed_ = 64;
+  Star stars_[kMaxStars];
+};
+
+/**
+ * Sum of three moving sine waves (columns, rows, diagonals), lit where above a threshold.
+ * Cost per frame: w + h + (w + h) table lookups, then one add and compare per pixel.
+ */
+class PlasmaEffect : public Effect {
+ public:
+  PlasmaEffect(uint8_t w, uint8_t h, uint32_t seed);
+
+  /* The sum runs from -381 to 381; 0 lights about half the screen */
+  void setThreshold(int16_t threshold) { threshold_ = threshold; }
+
+  void step(uint32_t dtMs) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  int16_t threshold_ = 0;
+  uint32_t phase_[3];  // 24.8 fixed point angles
+};
+
+/**
+ * Water surface: drops fall at random places and their rings spread and fade (two-buffer height field).
+ * Runs at 25 ticks per second. Cost per tick: 4 adds and 2 shifts per pixel; render one compare per pixel.
+ */
+class RippleEffect : public Effect {
+ public:
+  RippleEffect(uint8_t w, uint8_t h, uint32_t seed);
+
+  /* Drop a stone at x, y */
+  void drop(uint8_t x, uint8_t y);
+
+  void step(uint32_t dtMs) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  void tick();
+
+  uint32_t elapsed_ = 0;
+  uint8_t current_ = 0;  // index of the newest buffer
+  int16_t field_[2][kMaxSize * kMaxSize];
+};
+
+/**
+ * Flames rising from a flickering hot bottom row, cooling randomly as they go up.
+ * Runs at 25 ticks per second. Cost per tick: 4 loads, an add and a random per pixel; render one compare per pixel.
+ */
+class FireEffect : public Effect {
+ public:
+  FireEffect(uint8_t w, uint8_t h, uint32_t seed);
+
+  /* Heat is 0 - 255, pixels at least this hot are lit (default 80) */
+  void setThreshold(uint8_t threshold) { threshold_ = threshold; }
+
+  void step(uint32_t dtMs) override;
+  void render(GFXcanvas1* canvas) const override;
+
+ private:
+  void tick();
+
+  uint32_t elapsed_ = 0;
+  uint8_t threshold_ = 80;
+  uint8_t heat_[(kMaxSize + 2) * kMaxSize];  // two hidden source rows below the screen
+};
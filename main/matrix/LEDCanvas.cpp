@@ -1,18 +1,149 @@
 #include "LEDCanvas.h"
 
-#include <utility>
+#include "utils/ReverseBits.hpp"
 
-LEDCanvas::LEDCanvas(std::shared_ptr<LedMatrix> ledMatrix, uint16_t w, uint16_t h) : GFXcanvas1(w, h), ledMatrix(std::move(ledMatrix)) {}
+// Transpose an 8x8 block of MSB-first rows: out[i] holds column i of in
+// (Hacker's Delight, transpose8 on two 32-bit halves)
+static void transpose8x8(const uint8_t in[8], uint8_t out[8]) {
+  uint32_t x = (in[0] << 24) | (in[1] << 16) | (in[2] << 8) | in[3];
+  uint32_t y = (in[4] << 24) | (in[5] << 16) | (in[6] << 8) | in[7];
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  out[0] = x >> 24;
+  out[1] = x >> 16;
+  out[2] = x >> 8;
+  out[3] = x;
+  out[4] = y >> 24;
+  out[5] = y >> 16;
+  out[6] = y >> 8;
+  out[7] = y;
+}
+
+LEDCanvas::LEDCanvas(LedMatrix& ledMatrix, uint16_t w, uint16_t h)
+    : GFXcanvas1(w, h), ledMatrix(ledMatrix), windowWidth(w), windowHeight(h) {}
+
+LEDCanvas::LEDCanvas(LedMatrix& ledMatrix, uint16_t w, uint16_t h, uint8_t* storage)
+    : GFXcanvas1(w, h, storage), ledMatrix(ledMatrix), windowWidth(w), windowHeight(h) {}
 
 LEDCanvas::~LEDCanvas() = default;
 
+void LEDCanvas::setPresentRotation(uint8_t r) { presentRotation = r & 3; }
+
+void LEDCanvas::setPresentWindow(uint16_t w, uint16_t h) {
+  windowWidth = w;
+  windowHeight = h;
+}
+
+void LEDCanvas::setPresentOffset(int16_t x, int16_t y) {
+  presentX = x % WIDTH;
+  if (presentX < 0) presentX += WIDTH;
+  presentY = y % HEIGHT;
+  if (presentY < 0) presentY += HEIGHT;
+}
+
+uint8_t LEDCanvas::windowByte(int y, int byteX) const {
+  int row = presentY + y;
+  if (row >= HEIGHT) row %= HEIGHT;
+  const uint8_t* line = getBuffer() + row * getRowBytes();
+  int x = presentX + byteX * 8;
+  if (x >= WIDTH) x %= WIDTH;
+  int i = x >> 3, shift = x & 7;
+  if (x + 8 <= WIDTH) {
+    // the window byte lies within one row of the canvas: one or two neighbouring bytes
+    return shift ? (line[i] << shift) | (line[i + 1] >> (8 - shift)) : line[i];
+  }
+  // the window crosses the right edge: the last WIDTH - x pixels, then the first ones again
+  int tail = WIDTH - x;
+  uint8_t head = line[i] << shift;
+  if (shift + tail > 8) head |= line[i + 1] >> (8 - shift);
+  head &= 0xFF << (8 - tail);
+  return head | (line[0] >> tail);
+}
+
+const uint8_t* LEDCanvas::directWindow() const {
+  if ((presentX & 7) || presentX + windowWidth > WIDTH || presentY + windowHeight > HEIGHT) return nullptr;
+  return getBuffer() + presentY * getRowBytes() + presentX / 8;
+}
+
 void LEDCanvas::display() {
-  int devNum = ledMatrix->getDeviceCount();
-  int devNumHorizon = _width / 8;
-  uint8_t* buffer = getBuffer();
-  for (int h = 0; h < _height; ++h) {
-    for (int w = 0; w < devNumHorizon; ++w) {
-      ledMatrix->setRow(devNum - (h / 8 * devNumHorizon + w) - 1, h % 8, buffer[h * devNumHorizon + w]);
+  int devNum = ledMatrix.getDeviceCount();
+  int rowBytes = getRowBytes();
+  // unpanned (or at a byte-aligned offset clear of the edges) the window bytes are read in place
+  const uint8_t* window = directWindow();
+
+  if (presentRotation == 0) {
+    int devNumHorizon = windowWidth / 8;
+    for (int h = 0; h < windowHeight; ++h) {
+      if (window) {
+        for (int w = 0; w < devNumHorizon; ++w) {
+          ledMatrix.setRow(devNum - (h / 8 * devNumHorizon + w) - 1, h % 8, window[h * rowBytes + w]);
+        }
+        continue;
+      }
+      for (int w = 0; w < devNumHorizon; ++w) {
+        ledMatrix.setRow(devNum - (h / 8 * devNumHorizon + w) - 1, h % 8, windowByte(h, w));
+      }
+    }
+    return;
+  }
+
+  // panel blocks of 8x8, each one built from one block of the window
+  int panelBlocksW = (presentRotation & 1 ? windowHeight : windowWidth) / 8;
+  int panelBlocksH = (presentRotation & 1 ? windowWidth : windowHeight) / 8;
+  uint8_t src[8];  // window block rows, top to bottom
+  uint8_t block[8];
+  uint8_t rows[8];
+  for (int by = 0; by < panelBlocksH; ++by) {
+    for (int bx = 0; bx < panelBlocksW; ++bx) {
+      int cx, cy;  // window block shown at panel block (bx, by)
+      switch (presentRotation) {
+        case 1:
+          cx = by;
+          cy = panelBlocksW - 1 - bx;
+          break;
+        case 2:
+          cx = panelBlocksW - 1 - bx;
+          cy = panelBlocksH - 1 - by;
+          break;
+        default:
+          cx = panelBlocksH - 1 - by;
+          cy = bx;
+          break;
+      }
+      for (int i = 0; i < 8; ++i) src[i] = window ? window[(cy * 8 + i) * rowBytes + cx] : windowByte(cy * 8 + i, cx);
+      switch (presentRotation) {
+        case 1:
+          // panel row r = canvas column r, read bottom to top
+          for (int i = 0; i < 8; ++i) block[i] = src[7 - i];
+          transpose8x8(block, rows);
+          break;
+        case 2:
+          for (int i = 0; i < 8; ++i) rows[i] = reverseBits(src[7 - i]);
+          break;
+        default:
+          // panel row r = canvas column 7 - r, read top to bottom
+          transpose8x8(src, block);
+          for (int i = 0; i < 8; ++i) rows[i] = block[7 - i];
+          break;
+      }
+      int dev = devNum - (by * panelBlocksW + bx) - 1;
+      for (int r = 0; r < 8; ++r) {
+        ledMatrix.setRow(dev, r, rows[r]);
+      }
     }
   }
 }
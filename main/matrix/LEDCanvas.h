@@ -4,18 +4,67 @@
  */
 #pragma once
 
-#include <memory>
-
 #include "LedMatrix.h"
 #include "gfx/Adafruit_GFX.h"
 
 class LEDCanvas : public GFXcanvas1 {
  public:
-  LEDCanvas(std::shared_ptr<LedMatrix> ledMatrix, uint16_t w, uint16_t h);
+  /* The matrix is not owned and must outlive the canvas */
+  LEDCanvas(LedMatrix& ledMatrix, uint16_t w, uint16_t h);
+
+  /*
+   * Same, drawing into caller-owned storage instead of a heap buffer.
+   * Params :
+   * storage	GFX_CANVAS1_BYTES(w, h) bytes that outlive the canvas
+   */
+  LEDCanvas(LedMatrix& ledMatrix, uint16_t w, uint16_t h, uint8_t* storage);
   virtual ~LEDCanvas();
 
+  /*
+   * Rotate the finished frame while sending it, in 8x8 blocks, instead of drawing through setRotation().
+   * For 1 and 3 the canvas is the rotated (portrait) size, e.g. 16x32 for a vertical 32x16 panel,
+   * and both sizes must be multiples of 8.
+   * Params :
+   * r	0 thru 3, same direction as setRotation()
+   */
+  void setPresentRotation(uint8_t r);
+
+  /*
+   * Virtual canvas: the canvas may be larger than the panel (e.g. 128x16 or 32x64 for a 32x16 panel), content is
+   * drawn into it once and display() sends only a panel-sized window of it, taken at the present offset.
+   * The window is extracted byte by byte while sending, so panning or paging costs no drawing at all.
+   * Params :
+   * w, h	panel size in canvas pixels (16x32 with present rotation 1 or 3), multiples of 8. Default: the canvas size
+   */
+  void setPresentWindow(uint16_t w, uint16_t h);
+
+  /*
+   * Top left corner of the window in the canvas. It wraps around the canvas edges, so a window moved past the
+   * right end shows the start again (an endless ticker), and any offset is valid.
+   */
+  void setPresentOffset(int16_t x, int16_t y);
+  int16_t getPresentOffsetX() const { return presentX; }
+  int16_t getPresentOffsetY() const { return presentY; }
+
   void display();
 
  private:
-  std::shared_ptr<LedMatrix> ledMatrix;
+  /* Byte column byteX (8 pixels) of window row y */
+  uint8_t windowByte(int y, int byteX) const;
+  /* The window's first byte when it is a byte-aligned part of the canvas that does not wrap, else null */
+  const uint8_t* directWindow() const;
+
+  LedMatrix& ledMatrix;
+  uint8_t presentRotation = 0;
+  uint16_t windowWidth;
+  uint16_t windowHeight;
+  int16_t presentX = 0;  // kept within the canvas
+  int16_t presentY = 0;
+};
+
+/* LEDCanvas with its pixel buffer inside the object, a static instance needs no heap at all */
+template <uint16_t W, uint16_t H>
+class StaticLEDCanvas : private GFXcanvasStorage<GFX_CANVAS1_BYTES(W, H)>, public LEDCanvas {
+ public:
+  explicit StaticLEDCanvas(LedMatrix& ledMatrix) : LEDCanvas(ledMatrix, W, H, GFXcanvasStorage<GFX_CANVAS1_BYTES(W, H)>::storage) {}
 };
@@ -0,0 +1,113 @@
+#include "LayerCompositor.h"
+
+#include <cstring>
+#include <utility>
+
+// memcpy keeps the word access alias-safe, compilers lower it to a plain load/store
+template <typename Op>
+static void blendBytes(uint8_t* dst, const uint8_t* src, size_t bytes, Op op) {
+  size_t i = 0;
+  for (; i + 4 <= bytes; i += 4) {
+    uint32_t d, s;
+    memcpy(&d, dst + i, 4);
+    memcpy(&s, src + i, 4);
+    d = op(d, s);
+    memcpy(dst + i, &d, 4);
+  }
+  for (; i < bytes; ++i) {
+    dst[i] = op(dst[i], src[i]);
+  }
+}
+
+LayerCompositor::LayerCompositor(uint16_t w, uint16_t h) : width_(w), height_(h) {}
+
+int LayerCompositor::addLayer(BlendOp op) {
+  if (count_ >= kMaxLayers) return -1;
+  auto canvas = std::make_unique<GFXcanvas1>(width_, height_);
+  int index = addLayer(op, canvas.get());
+  if (index >= 0) layers_[index].owned = std::move(canvas);
+  return index;
+}
+
+int LayerCompositor::addLayer(BlendOp op, GFXcanvas1* canvas) {
+  if (count_ >= kMaxLayers) return -1;
+  if (canvas->width() != width_ || canvas->height() != height_) return -1;  // also catches a failed allocation
+  Layer& layer = layers_[count_];
+  layer.canvas = canvas;
+  layer.op = op;
+  changed_ = true;
+  return count_++;
+}
+
+GFXcanvas1* LayerCompositor::layer(int index) {
+  if (index < 0 || index >= count_) return nullptr;
+  return layers_[index].canvas;
+}
+
+void LayerCompositor::markDirty(int index) {
+  if (index < 0 || index >= count_) return;
+  layers_[index].dirty = true;
+}
+
+void LayerCompositor::setVisible(int index, bool visible) {
+  if (index < 0 || index >= count_) return;
+  Layer& layer = layers_[index];
+  if (layer.visible == visible) return;
+  layer.visible = visible;
+  changed_ = true;
+}
+
+bool LayerCompositor::isVisible(int index) const {
+  if (index < 0 || index >= count_) return false;
+  return layers_[index].visible;
+}
+
+void LayerCompositor::invalidate() { changed_ = true; }
+
+bool LayerCompositor::compose(GFXcanvas1* target) {
+  if (target->width() != width_ || target->height() != height_) return false;
+
+  bool needed = changed_;
+  for (int i = 0; i < count_ && !needed; ++i) {
+    needed = layers_[i].visible && layers_[i].dirty;
+  }
+  if (!needed) return false;
+
+  uint8_t* dst = target->getBuffer();
+  const size_t bytes = ((width_ + 7) / 8) * height_;
+  bool empty = true;  // dst still all zero: OR and XOR degrade to a copy
+  for (int i = 0; i < count_; ++i) {
+    Layer& layer = layers_[i];
+    layer.dirty = false;
+    if (!layer.visible) continue;
+    const uint8_t* src = layer.canvas->getBuffer();
+    switch (layer.op) {
+      case BlendOp::kOr:
+        if (empty) {
+          memcpy(dst, src, bytes);
+        } else {
+          blendBytes(dst, src, bytes, [](auto d, auto s) { return d | s; });
+        }
+        empty = false;
+        break;
+      case BlendOp::kAndNot:
+        if (!empty) {
+          blendBytes(dst, src, bytes, [](auto d, auto s) { return d & ~s; });
+        }
+        break;
+      case BlendOp::kXor:
+        if (empty) {
+          memcpy(dst, src, bytes);
+        } else {
+          blendBytes(dst, src, bytes, [](auto d, auto s) { return d ^ s; });
+        }
+        empty = false;
+        break;
+    }
+  }
+  if (empty) {
+    memset(dst, 0, bytes);
+  }
+  changed_ = false;
+  return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * Keeps several 1-bit layers of the same size and combines the visible ones,
+ * bottom to top, into a target canvas with word-wide blend ops.
+ * A composite only happens when a visible layer was redrawn (markDirty) or a
+ * layer was shown/hidden, so blinking a region is one composite, no redraw.
+ */
+class LayerCompositor {
+ public:
+  enum class BlendOp : uint8_t {
+    kOr,      // dst |= layer
+    kAndNot,  // dst &= ~layer, layer acts as an erase mask
+    kXor,     // dst ^= layer
+  };
+
+  static const int kMaxLayers = 8;
+
+  LayerCompositor(uint16_t w, uint16_t h);
+  LayerCompositor(const LayerCompositor&) = delete;
+  const LayerCompositor& operator=(const LayerCompositor&) = delete;
+
+  /* Append a layer on top of the existing ones, returns its index or -1 if full (or out of memory) */
+  int addLayer(BlendOp op);
+
+  /* Same, drawing into a caller-owned canvas of the compositor size (e.g. a GFXstaticCanvas1), no heap */
+  int addLayer(BlendOp op, GFXcanvas1* canvas);
+
+  /* Canvas of the layer to draw into, call markDirty() when done */
+  GFXcanvas1* layer(int index);
+
+  void markDirty(int index);
+
+  void setVisible(int index, bool visible);
+
+  bool isVisible(int index) const;
+
+  /* Force the next compose(), e.g. after the target was drawn by someone else */
+  void invalidate();
+
+  /*
+   * Combine the visible layers into target, which must have the same size.
+   * Returns false (target untouched) if nothing changed since the last call.
+   */
+  bool compose(GFXcanvas1* target);
+
+ private:
+  struct Layer {
+    std::unique_ptr<GFXcanvas1> owned;
+    GFXcanvas1* canvas = nullptr;
+    BlendOp op = BlendOp::kOr;
+    bool visible = true;
+    bool dirty = true;
+  };
+
+  uint16_t width_;
+  uint16_t height_;
+  Layer layers_[kMaxLayers];
+  int count_ = 0;
+  bool changed_ = true;
+};
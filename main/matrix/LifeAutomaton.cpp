@@ -0,0 +1,119 @@
+#include "LifeAutomaton.h"
+
+#include <cstring>
+
+#include "utils/XorShift32.hpp"
+
+// full adder on 32 cells at once
+static inline void carrySave(uint32_t a, uint32_t b, uint32_t c, uint32_t& sum, uint32_t& carry) {
+  uint32_t ab = a ^ b;
+  sum = ab ^ c;
+  carry = (a & b) | (ab & c);
+}
+
+LifeAutomaton::LifeAutomaton(uint8_t w, uint8_t h) : board_(w, h) {}
+
+bool LifeAutomaton::setRule(const char* rule) {
+  uint16_t sets[2] = {0, 0};  // birth, survive
+  for (int i = 0; i < 2; ++i) {
+    char letter = i == 0 ? 'B' : 'S';
+    if ((*rule & ~0x20) != letter) return false;  // either case
+    for (++rule; *rule >= '0' && *rule <= '8'; ++rule) sets[i] |= 1 << (*rule - '0');
+    if (i == 0 && *rule++ != '/') return false;
+  }
+  if (*rule) return false;
+  birth_ = sets[0];
+  survive_ = sets[1];
+  return true;
+}
+
+void LifeAutomaton::clear() {
+  board_.clear();
+  memset(previous_, 0, sizeof(previous_));
+  generation_ = 0;
+}
+
+void LifeAutomaton::randomize(uint32_t seed, uint8_t percent) {
+  clear();
+  XorShift32 random(seed);
+  const uint32_t threshold = (uint32_t)(percent > 100 ? 100 : percent) * 0xFFFF / 100;
+  for (uint8_t y = 0; y < board_.height(); ++y) {
+    for (uint8_t x = 0; x < board_.width(); ++x) {
+      if ((random.next() & 0xFFFF) < threshold) board_.set(x, y);
+    }
+  }
+}
+
+void LifeAutomaton::setCell(uint8_t x, uint8_t y, bool alive) { board_.set(x, y, alive); }
+
+bool LifeAutomaton::cell(uint8_t x, uint8_t y) const { return board_.test(x, y); }
+
+void LifeAutomaton::load(const GFXcanvas1* canvas) {
+  clear();
+  board_.load(canvas);
+}
+
+bool LifeAutomaton::step() {
+  uint32_t next[kMaxSize];
+  const uint32_t* rows = board_.rows();
+  const uint8_t width = board_.width(), height = board_.height();
+  const uint32_t mask = board_.rowMask();
+  const uint32_t lastCell = 1u << (32 - width);
+  const uint8_t wrapShift = width - 1;
+  const uint16_t rule = birth_ | survive_;
+
+  for (uint8_t y = 0; y < height; ++y) {
+    uint32_t up, down;
+    if (wrap_) {
+      up = rows[y ? y - 1 : height - 1];
+      down = rows[y + 1 < height ? y + 1 : 0];
+    } else {
+      up = y ? rows[y - 1] : 0;
+      down = y + 1 < height ? rows[y + 1] : 0;
+    }
+    const uint32_t center = rows[y];
+
+    // the neighbour on the left of each cell is one bit up, on the right one bit down
+    uint32_t n[8] = {up, down};
+    const uint32_t lines[3] = {up, center, down};
+    for (int i = 0; i < 3; ++i) {
+      uint32_t west = lines[i] >> 1, east = lines[i] << 1;
+      if (wrap_) {
+        west |= lines[i] << wrapShift;
+        east |= (lines[i] >> wrapShift) & lastCell;
+      }
+      n[2 + 2 * i] = west & mask;
+      n[3 + 2 * i] = east & mask;
+    }
+
+    // bit-sliced neighbour count s3 s2 s1 s0 (0 - 8) of every cell
+    uint32_t sumA, carryA, sumB, carryB, s0, carryC, twos, carryD;
+    carrySave(n[0], n[1], n[2], sumA, carryA);
+    carrySave(n[3], n[4], n[5], sumB, carryB);
+    uint32_t sumC = n[6] ^ n[7], carryE = n[6] & n[7];
+    carrySave(sumA, sumB, sumC, s0, carryC);
+    carrySave(carryA, carryB, carryE, twos, carryD);
+    uint32_t s1 = twos ^ carryC;
+    uint32_t fours = twos & carryC;
+    uint32_t s2 = carryD ^ fours;
+    uint32_t s3 = carryD & fours;
+
+    uint32_t result = 0;
+    for (uint8_t count = 0; count <= 8; ++count) {
+      if (!(rule & (1 << count))) continue;
+      uint32_t match = (count & 1 ? s0 : ~s0) & (count & 2 ? s1 : ~s1) & (count & 4 ? s2 : ~s2) & (count & 8 ? s3 : ~s3);
+      uint32_t cells = (birth_ & (1 << count) ? ~center : 0) | (survive_ & (1 << count) ? center : 0);
+      result |= match & cells;
+    }
+    next[y] = result & mask;
+  }
+
+  const size_t bytes = height * sizeof(uint32_t);
+  bool changed = memcmp(next, rows, bytes) != 0 && memcmp(next, previous_, bytes) != 0;
+  memcpy(previous_, rows, bytes);
+  for (uint8_t y = 0; y < height; ++y) board_.setRow(y, next[y]);
+  ++generation_;
+  return changed;
+}
+
+void LifeAutomaton::render(GFXcanvas1* canvas) const { board_.render(canvas, true); }
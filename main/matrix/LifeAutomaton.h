@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Bitboard.h"
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * Life-like cellular automaton on a board up to 32x32, for idle screen effects.
+ * The cells are a Bitboard, one 32-bit word per row (leftmost cell in bit 31), and a generation is computed
+ * a whole row at a time: the eight neighbour words are summed with carry-save adders into a bit-sliced
+ * 4-bit count per cell, which the birth/survival rule then selects from, with no per-cell loop.
+ */
+class LifeAutomaton {
+ public:
+  static const int kMaxSize = Bitboard::kMaxSize;
+
+  /* w and h are clamped to 1 - kMaxSize */
+  LifeAutomaton(uint8_t w, uint8_t h);
+  LifeAutomaton(const LifeAutomaton&) = delete;
+  const LifeAutomaton& operator=(const LifeAutomaton&) = delete;
+
+  /*
+   * Params :
+   * rule	"B3/S23" notation: neighbour counts giving birth, then counts a live cell survives with,
+   *	e.g. "B36/S23" (HighLife). Returns false (rule unchanged) if it does not parse. Default B3/S23
+   */
+  bool setRule(const char* rule);
+
+  /* Toroidal board: edges wrap around (default). Otherwise cells beyond the edges are dead */
+  void setWrap(bool wrap) { wrap_ = wrap; }
+
+  void clear();
+
+  /* Fill about percent of the cells, from a seed (e.g. esp_random()) */
+  void randomize(uint32_t seed, uint8_t percent);
+
+  void setCell(uint8_t x, uint8_t y, bool alive);
+  bool cell(uint8_t x, uint8_t y) const;
+
+  /* Take the board from the top left of canvas (not rotated), e.g. text drawn there */
+  void load(const GFXcanvas1* canvas);
+
+  /*
+   * Compute the next generation.
+   * Returns false if it equals the current or the previous one: the board is still (or empty) or blinks
+   * with period 2, time to reseed an idle effect.
+   */
+  bool step();
+
+  /* Write the board to the top left of canvas, clipped to its size */
+  void render(GFXcanvas1* canvas) const;
+
+  uint32_t generation() const { return generation_; }
+  uint8_t width() const { return board_.width(); }
+  uint8_t height() const { return board_.height(); }
+  const Bitboard& board() const { return board_; }
+
+ private:
+  Bitboard board_;
+  bool wrap_ = true;
+  uint16_t birth_ = 1 << 3;  // bit n: n neighbours
+  uint16_t survive_ = (1 << 2) | (1 << 3);
+  uint32_t generation_ = 0;
+  uint32_t previous_[kMaxSize] = {};
+};
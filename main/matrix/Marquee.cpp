@@ -0,0 +1,128 @@
+#include "Marquee.h"
+
+Marquee::Marquee(GFXcanvas1* strip, int16_t windowWidth) : strip_(strip), window_(windowWidth) {}
+
+// a marquee is a single line: line breaks show as spaces
+uint32_t Marquee::next(const char*& text) const {
+  uint32_t codepoint = utf8_ ? GFXutf8Decoder::next(text) : (uint8_t)*text++;
+  return codepoint == '\n' ? ' ' : codepoint;
+}
+
+void Marquee::setText(const char* text) {
+  text_ = text;
+  utf8_ = strip_->getUnicodeFont() != nullptr;
+  ascent_ = strip_->getTextAscent();
+  width_ = 0;
+  for (const char* p = text; *p;) {
+    uint32_t codepoint = next(p);
+    if (codepoint != '\r') width_ += strip_->getAdvance(codepoint);
+  }
+  restart();
+}
+
+void Marquee::restart() {
+  if (!text_ || width_ == 0) {
+    strip_->resetViewport();
+    strip_->fillScreen(0);
+    pos_ = base_ = 0;
+    state_ = State::kDone;
+    return;
+  }
+  frac_ = 0;
+  if (pause_) {
+    state_ = State::kHoldStart;
+    hold_ = pause_;
+    pos_ = 0;
+  } else {
+    state_ = State::kScroll;
+    pos_ = -window_;
+  }
+  // force a re-render from the first glyph
+  base_ = INT32_MAX;
+  seek(pos_);
+}
+
+bool Marquee::tick(uint32_t elapsedMs) {
+  int32_t old = pos_;
+  bool restarted = false;
+  while (elapsedMs > 0 && state_ != State::kDone) {
+    if (state_ != State::kScroll) {
+      uint32_t used = elapsedMs < hold_ ? elapsedMs : hold_;
+      hold_ -= used;
+      elapsedMs -= used;
+      if (hold_) break;
+      if (state_ == State::kHoldStart) {
+        state_ = State::kScroll;
+        continue;
+      }
+    } else {
+      int32_t end = pause_ ? (width_ > window_ ? width_ - window_ : 0) : width_;
+      frac_ += elapsedMs * speed_;
+      elapsedMs = 0;
+      pos_ += frac_ / 1000;
+      frac_ %= 1000;
+      if (pos_ < end) break;
+      pos_ = end;
+      if (pause_) {
+        state_ = State::kHoldEnd;
+        hold_ = pause_;
+        continue;
+      }
+    }
+    // a pass is over: the rest of elapsedMs is dropped
+    if (loop_) {
+      restart();
+      restarted = true;
+    } else {
+      state_ = State::kDone;
+    }
+    break;
+  }
+  if (pos_ != old) seek(pos_);
+  return restarted || pos_ != old;
+}
+
+void Marquee::seek(int32_t pos) {
+  const int16_t stripWidth = strip_->width();
+  if (pos >= base_ && pos + window_ <= base_ + stripWidth) return;
+
+  strip_->resetViewport();
+  if (pos < base_) {
+    strip_->fillScreen(0);
+    filled_ = pos;
+    pending_ = text_;
+    pendingX_ = 0;
+  } else if (pos - base_ < stripWidth) {
+    // keep the columns still needed, moved to the left edge
+    strip_->scroll(base_ - pos, 0, 0);
+  } else {
+    strip_->fillScreen(0);
+  }
+  base_ = pos;
+  if (filled_ < base_) filled_ = base_;
+  fill();
+}
+
+void Marquee::fill() {
+  const int32_t end = base_ + strip_->width();
+  if (filled_ >= end) return;
+
+  strip_->pushClipRect(filled_ - base_, 0, end - filled_, strip_->height());
+  while (*pending_ && pendingX_ < end) {
+    const char* p = pending_;
+    uint32_t codepoint = next(p);
+    uint8_t advance = codepoint == '\r' ? 0 : strip_->getAdvance(codepoint);
+    if (advance && pendingX_ + advance > filled_) strip_->drawCodepoint(pendingX_ - base_, ascent_, codepoint);
+    // a glyph cut by the strip end stays pending and is drawn again, clipped to the next columns
+    if (pendingX_ + advance > end) break;
+    pending_ = p;
+    pendingX_ += advance;
+  }
+  strip_->popViewport();
+  filled_ = end;
+}
+
+void Marquee::draw(GFXcanvas1* target, int16_t x, int16_t y, uint8_t op) const {
+  if (!text_) return;
+  target->blit(x, y, *strip_, pos_ - base_, 0, window_, strip_->height(), op);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * Scrolling text that is rasterized once into an off-screen 1-bit strip; every frame only copies
+ * a shifted window of the strip to the target with one blit.
+ * The strip may be much narrower than the message: it holds a moving section of the rendered text,
+ * and when the window reaches its end the strip is shifted left and the new columns are drawn,
+ * so memory stays at the strip size however long the text is.
+ * Text is drawn with the font, text size and colors set on the strip canvas, on a clear (0) background.
+ */
+class Marquee {
+ public:
+  /*
+   * Params :
+   * strip	canvas to render into, not owned; at least windowWidth wide, as high as a text line
+   * windowWidth	width of the visible part, e.g. the panel width
+   */
+  Marquee(GFXcanvas1* strip, int16_t windowWidth);
+  Marquee(const Marquee&) = delete;
+  const Marquee& operator=(const Marquee&) = delete;
+
+  /* Start showing text (UTF-8 if the strip has a Unicode font), which must stay valid while it is shown */
+  void setText(const char* text);
+
+  /* Scroll speed in pixels per second */
+  void setSpeed(uint16_t pixelsPerSecond) { speed_ = pixelsPerSecond; }
+
+  /* Start over when the text has scrolled through, otherwise stop (finished() becomes true) */
+  void setLoop(bool loop) { loop_ = loop; }
+
+  /*
+   * Params :
+   * ms	0: the text enters from the right and leaves to the left. Otherwise it starts left aligned,
+   *	holds ms, scrolls until its end is right aligned and holds ms again (text that fits does not move)
+   */
+  void setPause(uint16_t ms) { pause_ = ms; }
+
+  /* Advance the animation, returns true if the visible window changed */
+  bool tick(uint32_t elapsedMs);
+
+  /* Copy the current window to target with its top left corner at x, y */
+  void draw(GFXcanvas1* target, int16_t x, int16_t y, uint8_t op = GFX_ROP_COPY) const;
+
+  bool finished() const { return state_ == State::kDone; }
+
+  int32_t textWidth() const { return width_; }
+
+ private:
+  enum class State : uint8_t {
+    kHoldStart,
+    kScroll,
+    kHoldEnd,
+    kDone,
+  };
+
+  uint32_t next(const char*& text) const;
+  void restart();
+  void seek(int32_t pos);
+  void fill();
+
+  GFXcanvas1* strip_;
+  int16_t window_;
+  uint16_t speed_ = 16;
+  uint16_t pause_ = 0;
+  bool loop_ = true;
+  bool utf8_ = false;
+
+  const char* text_ = nullptr;
+  int32_t width_ = 0;
+  int16_t ascent_ = 0;
+
+  State state_ = State::kDone;
+  int32_t pos_ = 0;       // text x at the left edge of the window
+  uint32_t frac_ = 0;     // sub-pixel progress, in 1/1000 pixel
+  uint32_t hold_ = 0;     // ms left in a pause
+
+  // The strip holds text columns [base_, base_ + strip width), rendered up to filled_
+  int32_t base_ = 0;
+  int32_t filled_ = 0;
+  const char* pending_ = nullptr;  // first glyph not completely in the strip yet
+  int32_t pendingX_ = 0;
+};
@@ -0,0 +1,116 @@
+#include "ScreenTransition.h"
+
+// shifts by the full word width are undefined in C++, these give 0
+static inline uint32_t shiftLeft(uint32_t v, uint8_t n) { return n < 32 ? v << n : 0; }
+static inline uint32_t shiftRight(uint32_t v, uint8_t n) { return n < 32 ? v >> n : 0; }
+
+// floor(sqrt(v))
+static uint32_t isqrt(uint32_t v) {
+  uint32_t root = 0;
+  for (uint32_t bit = 1u << 30; bit; bit >>= 2) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+  }
+  return root;
+}
+
+static uint32_t readRow(const GFXcanvas1* canvas, uint8_t y) {
+  const int16_t stride = canvas->getRowBytes();
+  return gfxRowWord(canvas->getBuffer() + y * stride, stride < 4 ? stride : 4);
+}
+
+ScreenTransition::ScreenTransition(uint8_t w, uint8_t h, uint32_t seed)
+    : width_(w < 1 ? 1 : w > kMaxSize ? kMaxSize : w),
+      height_(h < 1 ? 1 : h > kMaxSize ? kMaxSize : h),
+      random_(seed),
+      incoming_(width_, height_, storage_) {
+  widthMask_ = ~0u << (32 - width_);
+}
+
+void ScreenTransition::start(const GFXcanvas1* from, Kind kind, uint8_t frames) {
+  const uint8_t lines = from->height() < height_ ? from->height() : height_;
+  const uint32_t mask = from->width() < width_ ? widthMask_ & (~0u << (32 - from->width())) : widthMask_;
+  for (uint8_t y = 0; y < height_; ++y) outgoing_[y] = y < lines ? readRow(from, y) & mask : 0;
+  if (kind == Kind::kDissolve) {
+    for (auto& plane : rank_) {
+      for (uint8_t y = 0; y < height_; ++y) plane[y] = random_.next();
+    }
+  }
+  incoming_.fillScreen(0);
+  kind_ = kind;
+  frame_ = 0;
+  frames_ = frames ? frames : 1;
+}
+
+uint32_t ScreenTransition::revealMask(uint8_t y, uint8_t level, uint8_t edge, uint32_t radius2) const {
+  switch (kind_) {
+    case Kind::kWipe:
+      return shiftLeft(~0u, 32 - edge);
+    case Kind::kDissolve: {
+      // rank < level, compared on the bit-sliced ranks from the top bit down, 32 pixels at once
+      uint32_t less = 0, equal = ~0u;
+      for (int bit = 3; bit >= 0; --bit) {
+        const uint32_t plane = rank_[bit][y];
+        if (level & (1 << bit)) {
+          less |= equal & ~plane;
+          equal &= plane;
+        } else {
+          equal &= ~plane;
+        }
+      }
+      return level >= 16 ? ~0u : less;
+    }
+    case Kind::kIris: {
+      // in doubled coordinates, so the center sits between pixels on even sizes: pixel x is at 2x+1-w
+      const int32_t dy = 2 * y + 1 - height_;
+      const int32_t rest = (int32_t)radius2 - dy * dy;
+      if (rest <= 0) return 0;
+      const int32_t reach = isqrt(rest - 1);  // |dx| <= reach is inside the circle
+      int32_t left = (width_ - reach) / 2, right = (width_ - 1 + reach) / 2;
+      if (left < 0) left = 0;
+      if (right > width_ - 1) right = width_ - 1;
+      if (left > right) return 0;
+      return shiftRight(~0u, left) & shiftLeft(~0u, 31 - right);
+    }
+    default:
+      return 0;
+  }
+}
+
+bool ScreenTransition::nextFrame(GFXcanvas1* target) {
+  if (!running()) return false;
+  ++frame_;
+
+  // progress as pixels covered from the side (wipe, slide, push), 16ths (dissolve) and squared radius (iris)
+  const uint8_t edge = (uint16_t)width_ * frame_ / frames_;
+  const uint8_t level = 16 * frame_ / frames_;
+  const uint32_t maxRadius = isqrt((width_ - 1) * (width_ - 1) + (height_ - 1) * (height_ - 1)) + 1;
+  const uint32_t radius = maxRadius * frame_ / frames_;
+  const uint32_t radius2 = radius * radius;
+  const bool last = frame_ == frames_;
+
+  uint32_t rows[kMaxSize];
+  for (uint8_t y = 0; y < height_; ++y) {
+    const uint32_t from = outgoing_[y];
+    const uint32_t to = readRow(&incoming_, y) & widthMask_;
+    uint32_t row;
+    if (last) {
+      row = to;
+    } else if (kind_ == Kind::kSlide) {
+      const uint8_t offset = width_ - edge;
+      row = (from & ~shiftRight(widthMask_, offset)) | shiftRight(to, offset);
+    } else if (kind_ == Kind::kPush) {
+      row = (shiftLeft(from, edge) | shiftRight(to, width_ - edge)) & widthMask_;
+    } else {
+      const uint32_t mask = revealMask(y, level, edge, radius2);
+      row = (from & ~mask) | (to & mask);
+    }
+    rows[y] = row;
+  }
+  target->drawBitmap(0, 0, rows, width_, height_, 1, 0);
+  return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+#include "utils/XorShift32.hpp"
+
+/**
+ * Animated change from one screen to the next over a number of frames: wipe, slide, push, dissolve or iris.
+ * start() takes a snapshot of the outgoing screen (what the panel shows now); the incoming screen keeps being drawn,
+ * into incoming() instead of the panel, and every nextFrame() blends the two into the panel canvas.
+ *
+ * Screens up to 32x32 (not rotated). Each row is one 32-bit word (leftmost pixel in bit 31, as the canvas stores it)
+ * and a frame is out = (outgoing & ~mask) | (incoming & mask) per row, with the mask (or the shifts, for slide and
+ * push) computed a word at a time: a few operations per row, well below what drawing a screen costs.
+ */
+class ScreenTransition {
+ public:
+  static const int kMaxSize = 32;
+
+  enum class Kind : uint8_t {
+    kWipe,      // the incoming screen is uncovered from left to right
+    kSlide,     // the incoming screen slides in from the right over the outgoing one
+    kPush,      // the incoming screen pushes the outgoing one out to the left
+    kDissolve,  // pixels switch over in random order
+    kIris,      // a circle opening from the center shows the incoming screen
+  };
+  static const int kKindNum = 5;
+
+  /* width and height are clamped to 1 - kMaxSize; seed drives the dissolve order (e.g. esp_random()) */
+  ScreenTransition(uint8_t w, uint8_t h, uint32_t seed);
+  ScreenTransition(const ScreenTransition&) = delete;
+  const ScreenTransition& operator=(const ScreenTransition&) = delete;
+
+  /*
+   * Begin a transition, also while one is running (its current blend is then the outgoing screen).
+   * Params :
+   * from	canvas of the outgoing screen, usually the panel itself; copied, clipped to the transition size
+   * kind	the effect
+   * frames	number of nextFrame() calls until the incoming screen is fully shown, at least 1
+   */
+  void start(const GFXcanvas1* from, Kind kind, uint8_t frames);
+
+  /* Canvas the incoming screen draws into while running(), cleared by start() */
+  GFXcanvas1* incoming() { return &incoming_; }
+
+  bool running() const { return frame_ < frames_; }
+
+  /*
+   * Write the next blended frame into the top left of target (not rotated).
+   * The last frame is the incoming screen as is, after it running() is false.
+   * Returns false (target untouched) if no transition is running.
+   */
+  bool nextFrame(GFXcanvas1* target);
+
+  uint8_t width() const { return width_; }
+  uint8_t height() const { return height_; }
+
+ private:
+  /* pixels (mask bits) of row y that show the incoming screen at progress frame / frames */
+  uint32_t revealMask(uint8_t y, uint8_t level, uint8_t edge, uint32_t radius2) const;
+
+  uint8_t width_;
+  uint8_t height_;
+  uint32_t widthMask_;  // the width_ pixels of a row
+  XorShift32 random_;
+  Kind kind_ = Kind::kWipe;
+  uint8_t frame_ = 0;
+  uint8_t frames_ = 0;
+  uint32_t outgoing_[kMaxSize] = {};
+  uint32_t rank_[4][kMaxSize];  // bit-sliced random rank 0 - 15 of every pixel, the dissolve order
+  uint8_t storage_[GFX_CANVAS1_BYTES(kMaxSize, kMaxSize)];
+  GFXcanvas1 incoming_;
+};
@@ -0,0 +1,140 @@
+#include "Sprites.h"
+
+#include "utils/ReverseBits.hpp"
+
+SpriteSheet::SpriteSheet(const uint8_t* bits, const uint8_t* masks, uint8_t w, uint8_t h, uint16_t count)
+    : bits_(bits), masks_(masks), width_(w), height_(h), count_(count) {
+  if (!bits || w < 1 || w > kMaxTileSize || h < 1 || h > kMaxTileSize) count_ = 0;
+  rowBytes_ = (w + 7) / 8;
+  widthMask_ = count_ ? ~0u << (32 - width_) : 0;
+}
+
+uint32_t SpriteSheet::row(const uint8_t* data, uint16_t tile, uint8_t y) const {
+  return gfxRowWord(data + ((uint32_t)tile * height_ + y) * rowBytes_, rowBytes_) & widthMask_;
+}
+
+void SpriteSheet::draw(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags) const {
+  blit(canvas, tile, x, y, flags, true);
+}
+
+void SpriteSheet::drawOpaque(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags) const {
+  blit(canvas, tile, x, y, flags, false);
+}
+
+void SpriteSheet::blit(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags, bool masked) const {
+  if (tile >= count_) return;
+  const int16_t canvasWidth = canvas->width(), canvasHeight = canvas->height();
+  if (x >= canvasWidth || y >= canvasHeight || x + width_ <= 0 || y + height_ <= 0) return;
+
+  const int16_t stride = canvas->getRowBytes();
+  // the window starts on the byte holding x (rounded down, also left of the canvas) and spans up to 5 bytes
+  const int16_t firstByte = x >> 3;
+  const uint8_t shift = x & 7;
+  const uint8_t bytes = (shift + width_ + 7) >> 3;
+  // window bytes inside the canvas, and the canvas pixels of the last one
+  const int16_t begin = firstByte < 0 ? -firstByte : 0;
+  const int16_t end = firstByte + bytes > stride ? stride - firstByte : bytes;
+  const uint8_t edge = canvasWidth % 8 ? 0xFF << (8 - canvasWidth % 8) : 0xFF;
+
+  const uint8_t top = y < 0 ? -y : 0;
+  const uint8_t bottom = y + height_ > canvasHeight ? canvasHeight - y : height_;
+  uint8_t* line = canvas->getBuffer() + (y + top) * stride;
+  for (uint8_t j = top; j < bottom; ++j, line += stride) {
+    const uint8_t source = flags & kFlipY ? height_ - 1 - j : j;
+    uint32_t bits = row(bits_, tile, source);
+    uint32_t mask = !masked ? widthMask_ : masks_ ? row(masks_, tile, source) : bits;
+    if (flags & kFlipX) {
+      bits = reverseBits(bits) << (32 - width_);
+      mask = reverseBits(mask) << (32 - width_);
+    }
+    const uint64_t bitWindow = (uint64_t)(bits & mask) << (32 - shift);
+    const uint64_t maskWindow = (uint64_t)mask << (32 - shift);
+    for (int16_t k = begin; k < end; ++k) {
+      uint8_t m = maskWindow >> (56 - 8 * k);
+      uint8_t& dst = line[firstByte + k];
+      if (firstByte + k == stride - 1) m &= edge;
+      dst = (dst & ~m) | ((uint8_t)(bitWindow >> (56 - 8 * k)) & m);
+    }
+  }
+}
+
+TileMap::TileMap(const SpriteSheet* sheet, uint8_t* cells, uint16_t cols, uint16_t rows)
+    : sheet_(sheet), cells_(cells), cols_(cells ? cols : 0), rows_(cells ? rows : 0) {}
+
+uint8_t TileMap::cell(int16_t col, int16_t row) const {
+  if (col < 0 || row < 0 || col >= cols_ || row >= rows_) return kEmpty;
+  return cells_[row * cols_ + col];
+}
+
+void TileMap::setCell(int16_t col, int16_t row, uint8_t tile) {
+  if (col < 0 || row < 0 || col >= cols_ || row >= rows_) return;
+  cells_[row * cols_ + col] = tile;
+}
+
+uint8_t TileMap::cellAt(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0) return kEmpty;
+  return cell(x / sheet_->tileWidth(), y / sheet_->tileHeight());
+}
+
+void TileMap::draw(GFXcanvas1* canvas, int16_t scrollX, int16_t scrollY) const {
+  canvas->fillScreen(0);
+  const int16_t tw = sheet_->tileWidth(), th = sheet_->tileHeight();
+  // cells in view, from the one under the top left corner (floor division, the scroll may be negative)
+  const int16_t col0 = scrollX >= 0 ? scrollX / tw : -((tw - 1 - scrollX) / tw);
+  const int16_t row0 = scrollY >= 0 ? scrollY / th : -((th - 1 - scrollY) / th);
+  for (int16_t row = row0; row * th - scrollY < canvas->height(); ++row) {
+    if (row < 0 || row >= rows_) continue;
+    for (int16_t col = col0; col * tw - scrollX < canvas->width(); ++col) {
+      const uint8_t tile = cell(col, row);
+      if (tile != kEmpty) sheet_->drawOpaque(canvas, tile, col * tw - scrollX, row * th - scrollY);
+    }
+  }
+}
+
+int SpriteList::add(uint16_t tile, int16_t x, int16_t y, int8_t z) {
+  if (count_ >= kMaxSprites) return -1;
+  int id = 0;
+  while (used_ & (1u << id)) ++id;
+  used_ |= 1u << id;
+  Sprite& sprite = sprites_[id];
+  sprite = Sprite();
+  sprite.tile = tile;
+  sprite.x = x;
+  sprite.y = y;
+  sprite.z = z;
+  order_[count_++] = id;
+  return id;
+}
+
+void SpriteList::remove(int id) {
+  if (!sprite(id)) return;
+  used_ &= ~(1u << id);
+  uint8_t i = 0;
+  while (order_[i] != id) ++i;
+  for (--count_; i < count_; ++i) order_[i] = order_[i + 1];
+}
+
+void SpriteList::clear() {
+  used_ = 0;
+  count_ = 0;
+}
+
+SpriteList::Sprite* SpriteList::sprite(int id) {
+  if (id < 0 || id >= kMaxSprites || !(used_ & (1u << id))) return nullptr;
+  return &sprites_[id];
+}
+
+void SpriteList::draw(GFXcanvas1* canvas, int16_t viewX, int16_t viewY) const {
+  // stable insertion sort by z, a few dozen compares for a full list
+  uint8_t order[kMaxSprites];
+  for (uint8_t i = 0; i < count_; ++i) {
+    const uint8_t id = order_[i];
+    uint8_t j = i;
+    for (; j > 0 && sprites_[order[j - 1]].z > sprites_[id].z; --j) order[j] = order[j - 1];
+    order[j] = id;
+  }
+  for (uint8_t i = 0; i < count_; ++i) {
+    const Sprite& sprite = sprites_[order[i]];
+    if (sprite.visible) sheet_->draw(canvas, sprite.tile, sprite.x - viewX, sprite.y - viewY, sprite.flags);
+  }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * 1-bit tiles up to 32x32, each with an optional mask, e.g. an array of GFXbitmap<8, 8> from bitmapbake.h:
+ *
+ *   static constexpr GFXbitmap<8, 8> icons[] = {wifiIcon, bellIcon};
+ *   static const SpriteSheet iconSheet(icons[0].rows[0], nullptr, 8, 8, 2);
+ *
+ * Tiles are drawn a row at a time: the row is shifted into a 64-bit window that starts on the destination byte, and
+ * each whole byte of the window is merged into the canvas, so there is no per-pixel work.
+ * The canvas must not be rotated; drawing is in buffer coordinates, clipped to the canvas.
+ */
+class SpriteSheet {
+ public:
+  static const int kMaxTileSize = 32;
+
+  enum Flags : uint8_t {
+    kFlipX = 1,  // mirrored left to right
+    kFlipY = 2,  // upside down
+  };
+
+  /*
+   * Params :
+   * bits	count tiles of h rows of (w + 7) / 8 bytes each, MSB-first, kept by the caller
+   * masks	same layout, set where the tile is opaque; null: the set pixels of a tile are its opaque ones
+   * w, h	tile size, 1 - kMaxTileSize (otherwise the sheet is empty)
+   */
+  SpriteSheet(const uint8_t* bits, const uint8_t* masks, uint8_t w, uint8_t h, uint16_t count);
+
+  uint8_t tileWidth() const { return width_; }
+  uint8_t tileHeight() const { return height_; }
+  uint16_t tileCount() const { return count_; }
+
+  /* Draw tile with its top left at x, y: the canvas takes the tile where the mask is set and is kept elsewhere */
+  void draw(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags = 0) const;
+
+  /* Same, ignoring the mask: the whole tile rectangle is copied */
+  void drawOpaque(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags = 0) const;
+
+ private:
+  void blit(GFXcanvas1* canvas, uint16_t tile, int16_t x, int16_t y, uint8_t flags, bool masked) const;
+  /* row of tile from data, leftmost pixel in bit 31 */
+  uint32_t row(const uint8_t* data, uint16_t tile, uint8_t y) const;
+
+  const uint8_t* bits_;
+  const uint8_t* masks_;
+  uint8_t width_;
+  uint8_t height_;
+  uint16_t count_;
+  uint8_t rowBytes_;
+  uint32_t widthMask_;  // the width_ pixels of a row
+};
+
+/**
+ * Grid of tile indexes from a SpriteSheet, any size: a level or a scrolling background larger than the panel.
+ * The cells are kept by the caller and can change at any time (e.g. a brick that was hit).
+ */
+class TileMap {
+ public:
+  static const uint8_t kEmpty = 0xFF;  // cell with no tile, drawn blank
+
+  /* cells: cols x rows tile indexes, row by row */
+  TileMap(const SpriteSheet* sheet, uint8_t* cells, uint16_t cols, uint16_t rows);
+
+  uint16_t cols() const { return cols_; }
+  uint16_t rows() const { return rows_; }
+  uint16_t pixelWidth() const { return cols_ * sheet_->tileWidth(); }
+  uint16_t pixelHeight() const { return rows_ * sheet_->tileHeight(); }
+
+  /* kEmpty outside the map */
+  uint8_t cell(int16_t col, int16_t row) const;
+  void setCell(int16_t col, int16_t row, uint8_t tile);
+
+  /* Cell under map pixel x, y, kEmpty outside the map */
+  uint8_t cellAt(int16_t x, int16_t y) const;
+
+  /*
+   * Fill the whole canvas (not rotated) with the map, map pixel scrollX, scrollY at its top left corner.
+   * Only the cells in view are drawn; empty cells and anything beyond the map are cleared.
+   */
+  void draw(GFXcanvas1* canvas, int16_t scrollX, int16_t scrollY) const;
+
+ private:
+  const SpriteSheet* sheet_;
+  uint8_t* cells_;
+  uint16_t cols_;
+  uint16_t rows_;
+};
+
+/**
+ * Fixed pool of sprites over one SpriteSheet, drawn masked in z order: the game objects of a screen.
+ */
+class SpriteList {
+ public:
+  static const int kMaxSprites = 32;
+
+  struct Sprite {
+    int16_t x = 0;
+    int16_t y = 0;
+    uint16_t tile = 0;
+    int8_t z = 0;        // higher is in front; equal z: the one added later is in front
+    uint8_t flags = 0;   // SpriteSheet::Flags
+    bool visible = true;
+  };
+
+  explicit SpriteList(const SpriteSheet* sheet) : sheet_(sheet) {}
+  SpriteList(const SpriteList&) = delete;
+  const SpriteList& operator=(const SpriteList&) = delete;
+
+  /* Returns the id of the new sprite, or -1 if all kMaxSprites are in use */
+  int add(uint16_t tile, int16_t x, int16_t y, int8_t z = 0);
+  void remove(int id);
+  void clear();
+
+  /* Sprite to move or change, null if id is not in use */
+  Sprite* sprite(int id);
+
+  /* Draw the visible sprites; a sprite at x, y lands on x - viewX, y - viewY of canvas (not rotated) */
+  void draw(GFXcanvas1* canvas, int16_t viewX = 0, int16_t viewY = 0) const;
+
+ private:
+  const SpriteSheet* sheet_;
+  Sprite sprites_[kMaxSprites];
+  uint32_t used_ = 0;       // bit id: sprites_[id] is in use
+  uint8_t order_[kMaxSprites];  // ids in the order they were added
+  uint8_t count_ = 0;
+};
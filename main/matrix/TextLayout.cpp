@@ -0,0 +1,179 @@
+#include "TextLayout.h"
+
+#include <cstring>
+
+void TextLayout::shape(Adafruit_GFX* gfx, const char* text, int16_t maxWidth, Shape* out) {
+  const bool utf8 = gfx->getUnicodeFont() != nullptr;
+  out->count = 0;
+  out->lineCount = 1;
+  out->lineWidth[0] = 0;
+  out->complete = true;
+
+  int lineStart = 0;  // first slot of the current line
+  int breakAt = -1;   // slot after the last space of the current line
+  while (*text) {
+    uint32_t codepoint = utf8 ? GFXutf8Decoder::next(text) : (uint8_t)*text++;
+    if (codepoint == '\r') continue;
+
+    bool newline = codepoint == '\n';
+    uint8_t advance = newline ? 0 : gfx->getAdvance(codepoint);
+    int16_t& width = out->lineWidth[out->lineCount - 1];
+    // a space never starts a line: it may hang past maxWidth and becomes the break point
+    if (!newline && codepoint != ' ' && maxWidth > 0 && width + advance > maxWidth && out->count > lineStart) {
+      // wrap after the last space of the line if there is one, the rest of the word moves down
+      int carry = breakAt > lineStart ? breakAt : out->count;
+      if (out->lineCount == kMaxLines) {
+        out->count = carry;
+        out->complete = false;
+        break;
+      }
+      int16_t shift = carry < out->count ? out->glyphs[carry].offset : width;
+      int16_t& next = out->lineWidth[out->lineCount];
+      next = 0;
+      for (int i = carry; i < out->count; ++i) {
+        Glyph& g = out->glyphs[i];
+        g.offset -= shift;
+        g.line = out->lineCount;
+        next += g.advance;
+      }
+      // trailing spaces stay on the broken line but take no room in its width
+      width = shift;
+      for (int i = carry - 1; i >= lineStart && out->glyphs[i].codepoint == ' '; --i) width -= out->glyphs[i].advance;
+      out->lineCount++;
+      lineStart = carry;
+      breakAt = -1;
+    }
+    if (newline) {
+      if (out->lineCount == kMaxLines) {
+        out->complete = false;
+        break;
+      }
+      out->lineWidth[out->lineCount++] = 0;
+      lineStart = out->count;
+      breakAt = -1;
+      continue;
+    }
+    if (out->count == kMaxGlyphs) {
+      out->complete = false;
+      break;
+    }
+
+    Glyph& g = out->glyphs[out->count++];
+    int16_t& lineWidth = out->lineWidth[out->lineCount - 1];
+    g.codepoint = codepoint;
+    g.advance = advance;
+    g.line = out->lineCount - 1;
+    g.offset = lineWidth;
+    g.x = g.y = 0;
+    lineWidth += advance;
+    if (codepoint == ' ') breakAt = out->count;
+  }
+}
+
+void TextLayout::assign(const Shape& shape) {
+  memcpy(glyphs_, shape.glyphs, shape.count * sizeof(Glyph));
+  memcpy(lineWidth_, shape.lineWidth, shape.lineCount * sizeof(int16_t));
+  count_ = shape.count;
+  lineCount_ = shape.lineCount;
+}
+
+bool TextLayout::setText(Adafruit_GFX* gfx, const char* text, int16_t maxWidth) {
+  Shape shaped;
+  shape(gfx, text, maxWidth, &shaped);
+  maxWidth_ = maxWidth;
+  lineHeight_ = gfx->getLineHeight();
+  ascent_ = gfx->getTextAscent();
+  assign(shaped);
+  position();
+  return shaped.complete;
+}
+
+void TextLayout::setBox(int16_t x, int16_t y, int16_t w, int16_t h, Align align) {
+  boxX_ = x;
+  boxY_ = y;
+  boxW_ = w;
+  boxH_ = h;
+  align_ = align;
+  position();
+}
+
+int16_t TextLayout::lineLeft(int line) const {
+  switch (align_) {
+    case Align::kCenter:
+      return boxX_ + (boxW_ - lineWidth_[line]) / 2;
+    case Align::kRight:
+      return boxX_ + boxW_ - lineWidth_[line];
+    default:
+      return boxX_;
+  }
+}
+
+int16_t TextLayout::blockTop() const { return boxH_ > 0 ? boxY_ + (boxH_ - lineCount_ * lineHeight_) / 2 : boxY_; }
+
+void TextLayout::position() {
+  int16_t top = blockTop();
+  for (int i = 0; i < count_; ++i) {
+    Glyph& g = glyphs_[i];
+    g.x = lineLeft(g.line) + g.offset;
+    g.y = top + g.line * lineHeight_;
+  }
+}
+
+void TextLayout::drawSlot(Adafruit_GFX* gfx, int index) const {
+  const Glyph& g = glyphs_[index];
+  gfx->drawCodepoint(g.x, g.y + ascent_, g.codepoint);
+}
+
+void TextLayout::draw(Adafruit_GFX* gfx) const {
+  for (int i = 0; i < count_; ++i) drawSlot(gfx, i);
+}
+
+int TextLayout::update(Adafruit_GFX* gfx, const char* text, uint16_t eraseColor) {
+  Shape shaped;
+  shape(gfx, text, maxWidth_, &shaped);
+
+  bool same = shaped.count == count_ && shaped.lineCount == lineCount_ && gfx->getLineHeight() == lineHeight_ &&
+              gfx->getTextAscent() == ascent_;
+  for (int i = 0; same && i < count_; ++i) {
+    const Glyph& a = glyphs_[i];
+    const Glyph& b = shaped.glyphs[i];
+    same = a.advance == b.advance && a.offset == b.offset && a.line == b.line;
+  }
+
+  if (same) {
+    int drawn = 0;
+    for (int i = 0; i < count_; ++i) {
+      Glyph& g = glyphs_[i];
+      if (g.codepoint == shaped.glyphs[i].codepoint) continue;
+      g.codepoint = shaped.glyphs[i].codepoint;
+      gfx->fillRect(g.x, g.y, g.advance, lineHeight_, eraseColor);
+      drawSlot(gfx, i);
+      drawn++;
+    }
+    return drawn;
+  }
+
+  int16_t x, y;
+  uint16_t w, h;
+  getBounds(&x, &y, &w, &h);
+  gfx->fillRect(x, y, w, h, eraseColor);
+  lineHeight_ = gfx->getLineHeight();
+  ascent_ = gfx->getTextAscent();
+  assign(shaped);
+  position();
+  draw(gfx);
+  return count_;
+}
+
+void TextLayout::getBounds(int16_t* x, int16_t* y, uint16_t* w, uint16_t* h) const {
+  int16_t left = INT16_MAX, right = INT16_MIN;
+  for (int line = 0; line < lineCount_; ++line) {
+    int16_t start = lineLeft(line);
+    if (start < left) left = start;
+    if (start + lineWidth_[line] > right) right = start + lineWidth_[line];
+  }
+  *x = left;
+  *y = blockTop();
+  *w = right - left;
+  *h = lineCount_ * lineHeight_;
+}
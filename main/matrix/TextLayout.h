@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+#include "gfx/Adafruit_GFX.h"
+
+/**
+ * A string measured and broken into lines once, with the position of every glyph kept in a fixed slot.
+ * Drawing again or moving the box reuses the measurement. update() with a text of the same shape
+ * (same advances and line breaks, e.g. a clock) redraws only the slots whose glyph changed.
+ * Measures with the font, text size and Unicode font the target has at setText()/update() time,
+ * and draws with its text colors.
+ */
+class TextLayout {
+ public:
+  enum class Align : uint8_t {
+    kLeft,
+    kCenter,
+    kRight,
+  };
+
+  static const int kMaxGlyphs = 32;  // update() shapes a second copy on the stack
+  static const int kMaxLines = 4;
+
+  struct Glyph {
+    uint32_t codepoint;
+    int16_t x;       // left edge on the target, valid after setBox()
+    int16_t y;       // line top on the target
+    int16_t offset;  // x within the line
+    uint8_t advance;
+    uint8_t line;
+  };
+
+  /*
+   * Params :
+   * maxWidth	break lines at spaces (or inside words longer than a line) to fit, 0: only at '\n'
+   * Returns false if the text was cut to kMaxGlyphs / kMaxLines.
+   */
+  bool setText(Adafruit_GFX* gfx, const char* text, int16_t maxWidth = 0);
+
+  /* Place the text: each line aligned within w, the block centered vertically if h > 0 */
+  void setBox(int16_t x, int16_t y, int16_t w, int16_t h = 0, Align align = Align::kLeft);
+
+  void draw(Adafruit_GFX* gfx) const;
+
+  /*
+   * Shape a new text with the previous maxWidth and box. If it has the same shape, only the changed slots
+   * are erased to eraseColor and redrawn; otherwise the old bounds are erased and everything is drawn.
+   * Returns the number of slots drawn.
+   */
+  int update(Adafruit_GFX* gfx, const char* text, uint16_t eraseColor = 0);
+
+  void getBounds(int16_t* x, int16_t* y, uint16_t* w, uint16_t* h) const;
+
+  int glyphCount() const { return count_; }
+  const Glyph& glyph(int index) const { return glyphs_[index]; }
+  int lineCount() const { return lineCount_; }
+
+ private:
+  struct Shape {
+    Glyph glyphs[kMaxGlyphs];
+    int16_t lineWidth[kMaxLines];
+    int count = 0;
+    int lineCount = 0;
+    bool complete = true;
+  };
+
+  static void shape(Adafruit_GFX* gfx, const char* text, int16_t maxWidth, Shape* out);
+  void assign(const Shape& shape);
+  int16_t lineLeft(int line) const;
+  int16_t blockTop() const;
+  void position();
+  void drawSlot(Adafruit_GFX* gfx, int index) const;
+
+  Glyph glyphs_[kMaxGlyphs];
+  int16_t lineWidth_[kMaxLines]{};
+  int count_ = 0;
+  int lineCount_ = 0;
+  int16_t maxWidth_ = 0;
+  uint8_t lineHeight_ = 0;
+  int16_t ascent_ = 0;
+
+  int16_t boxX_ = 0;
+  int16_t boxY_ = 0;
+  int16_t boxW_ = 0;
+  int16_t boxH_ = 0;
+  Align align_ = Align::kLeft;
+};
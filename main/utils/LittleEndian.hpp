@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// file formats (asset pack, font image, delta animation, GIF) live in flash or a file with no alignment promise:
+// read their little-endian fields byte-wise
+static inline uint16_t readU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t readU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+/* xorshift32 pseudo random numbers: 4 bytes of state, fast, not for anything secret */
+class XorShift32 {
+ public:
+  /* 0, the one state xorshift never leaves, is taken as 1 */
+  explicit XorShift32(uint32_t seed = 1) { this->seed(seed); }
+
+  void seed(uint32_t seed) { state_ = seed ? seed : 1; }
+
+  uint32_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  /* 0 - n-1 */
+  uint32_t below(uint32_t n) { return (uint64_t)next() * n >> 32; }
+
+ private:
+  uint32_t state_;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <chrono>
+
+/* Best time of runs runs of iterations calls of f, in ns per call */
+template <class F>
+double bestNs(F f, int iterations, int runs = 21) {
+  f();  // warm up caches and branch predictors
+  double best = 1e18;
+  for (int run = 0; run < runs; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    if (ns < best) best = ns;
+  }
+  return best;
+}
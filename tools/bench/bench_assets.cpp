@@ -0,0 +1,55 @@
+// AssetPack lookups in the 304-asset pack mkassets.py wrote into the build directory, read through a MappedRegion
+// of the file as the panel reads the assets partition: find() and findFrames() of every name in turn, and of names
+// missing from the pack.
+#include <cstdio>
+
+#include "asset/AssetPack.h"
+#include "bench.h"
+#include "font/MappedRegion.h"
+
+int main() {
+  const int kFrames = BENCH_ASSET_FRAMES;
+  MappedRegion region;
+  AssetPack pack;
+  if (!region.mapFile(BENCH_ASSET_PACK) || !pack.load(region.data(), region.size())) {
+    printf("%s: not an asset pack\n", BENCH_ASSET_PACK);
+    return 1;
+  }
+  static char names[kFrames][16], missing[kFrames][16];
+  for (int i = 0; i < kFrames; ++i) {
+    snprintf(names[i], sizeof(names[i]), "frames%d", i + 1);
+    snprintf(missing[i], sizeof(missing[i]), "absent%d", i + 1);
+    AssetPack::Frames frames;
+    if (!pack.findFrames(names[i], &frames) || frames.width != 8 || frames.height != 8) {
+      printf("%s: missing from the pack\n", names[i]);
+      return 1;
+    }
+  }
+
+  printf("%u assets, %u bytes\n", pack.assetCount(), (unsigned)region.size());
+  int i = 0, found = 0;
+  double ns = bestNs([&] { found += AssetPack::hashName(names[i++ % kFrames]) & 1; }, 1000000);
+  printf("%-14s %6.1f ns\n", "hashName", ns);
+  ns = bestNs(
+      [&] {
+        AssetPack::Asset asset;
+        found += pack.find(names[i++ % kFrames], &asset);
+      },
+      1000000);
+  printf("%-14s %6.1f ns\n", "find", ns);
+  ns = bestNs(
+      [&] {
+        AssetPack::Frames frames;
+        found += pack.findFrames(names[i++ % kFrames], &frames);
+      },
+      1000000);
+  printf("%-14s %6.1f ns\n", "findFrames", ns);
+  ns = bestNs(
+      [&] {
+        AssetPack::Asset asset;
+        found += pack.find(missing[i++ % kFrames], &asset);
+      },
+      1000000);
+  printf("%-14s %6.1f ns\n", "find, missing", ns);
+  return found ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+// Composite time of LayerCompositor for 2 to 8 layers of 32x16, the LED panel size.
+// Every iteration redraws the bottom layer (markDirty) so compose() runs in full.
+#include <cstdio>
+
+#include "bench.h"
+#include "matrix/LayerCompositor.h"
+
+int main() {
+  const int kMin = 2, kMax = LayerCompositor::kMaxLayers;
+  GFXcanvas1 target(32, 16);
+  LayerCompositor* compositors[kMax + 1] = {};
+  double best[kMax + 1];
+  for (int n = kMin; n <= kMax; ++n) {
+    compositors[n] = new LayerCompositor(32, 16);
+    for (int i = 0; i < n; ++i) {
+      // the time screen pattern: OR layers with an AND-NOT mask on top
+      compositors[n]->addLayer(i == n - 1 ? LayerCompositor::BlendOp::kAndNot : LayerCompositor::BlendOp::kOr);
+      compositors[n]->layer(i)->fillRect(i, i, 10, 5, 1);
+    }
+    best[n] = 1e18;
+  }
+  // the layer counts take turns, so a busy moment of the machine does not skew one of them
+  for (int run = 0; run < 21; ++run) {
+    for (int n = kMin; n <= kMax; ++n) {
+      LayerCompositor* compositor = compositors[n];
+      double ns = bestNs(
+          [&] {
+            compositor->markDirty(0);
+            compositor->compose(&target);
+          },
+          20000, 1);
+      if (ns < best[n]) best[n] = ns;
+    }
+  }
+  printf("layers  ns/compose\n");
+  for (int n = kMin; n <= kMax; ++n) {
+    printf("%6d  %10.1f\n", n, best[n]);
+    delete compositors[n];
+  }
+  return 0;
+}
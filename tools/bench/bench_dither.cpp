@@ -0,0 +1,35 @@
+// drawDitheredBitmap() of a 32x16 gray frame in every GFXdither mode, still and temporal,
+// against a per-pixel drawPixel() Bayer dither.
+#include <cstdint>
+#include <cstdio>
+
+#include "bench.h"
+#include "gfx/Adafruit_GFX.h"
+
+int main() {
+  static const uint8_t kBayer[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+  uint8_t gray[32 * 16];
+  uint32_t seed = 45;
+  for (auto& g : gray) {
+    seed = seed * 1103515245 + 12345;
+    g = seed >> 24;
+  }
+  GFXcanvas1 canvas(32, 16);
+  const char* names[] = {"threshold", "bayer", "floyd-steinberg", "atkinson"};
+  printf("%-16s %9s %9s  ns/frame\n", "mode", "still", "temporal");
+  for (uint8_t mode = GFX_DITHER_THRESHOLD; mode <= GFX_DITHER_ATKINSON; ++mode) {
+    uint8_t frame = 0;
+    double still = bestNs([&] { canvas.drawDitheredBitmap(0, 0, gray, 32, 16, mode); }, 100000);
+    double temporal = bestNs([&] { canvas.drawDitheredBitmap(0, 0, gray, 32, 16, mode | GFX_DITHER_TEMPORAL, frame++); }, 100000);
+    printf("%-16s %9.0f %9.0f\n", names[mode], still, temporal);
+  }
+  double perPixel = bestNs(
+      [&] {
+        for (int16_t y = 0; y < 16; ++y) {
+          for (int16_t x = 0; x < 32; ++x) canvas.drawPixel(x, y, gray[y * 32 + x] >= kBayer[y & 3][x & 3] * 16 + 8);
+        }
+      },
+      100000);
+  printf("%-16s %9.0f\n", "drawPixel bayer", perPixel);
+  return 0;
+}
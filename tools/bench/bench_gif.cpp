@@ -0,0 +1,39 @@
+// GifDecoder frames per second, reading the GIF through a MappedRegion of the file as the panel reads flash.
+// Without arguments it decodes the 2- and 256-color test animations mkgif.py wrote into the build directory.
+#include <cstdio>
+
+#include "asset/GifDecoder.h"
+#include "bench.h"
+#include "font/MappedRegion.h"
+
+int main(int argc, char** argv) {
+  const char* defaults[] = {BENCH_GIF_DIR "/wave2.gif", BENCH_GIF_DIR "/wave256.gif"};
+  const char* const* paths = argc > 1 ? argv + 1 : defaults;
+  const int count = argc > 1 ? argc - 1 : 2;
+  static GifDecoder decoder;  // 4.5 KB of LZW dictionary
+  GFXcanvas1 canvas(32, 16);
+  printf("%-40s %7s %10s %10s\n", "file", "frames", "us/frame", "frames/s");
+  for (int i = 0; i < count; ++i) {
+    MappedRegion region;
+    if (!region.mapFile(paths[i]) || !decoder.open(region.data(), region.size())) {
+      printf("%s: not a GIF\n", paths[i]);
+      return 1;
+    }
+    int frames = 0;
+    while (decoder.nextFrame(&canvas, 0, 0)) ++frames;
+    if (!frames) {
+      printf("%s: no frame decoded\n", paths[i]);
+      return 1;
+    }
+    // one call decodes the whole animation
+    double ns = bestNs(
+        [&] {
+          decoder.rewind();
+          while (decoder.nextFrame(&canvas, 0, 0)) {
+          }
+        },
+        200);
+    printf("%-40s %7d %10.2f %10.0f\n", paths[i], frames, ns / 1000 / frames, 1e9 * frames / ns);
+  }
+  return 0;
+}
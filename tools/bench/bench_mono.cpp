@@ -0,0 +1,48 @@
+// MonoImageDecoder::decode() of a 256x128 P4 image against plain memcpy of its rows: into a canvas of the same
+// width (one copy), a wider canvas (one copy per row) and at x = 3 (shifted), and a 32x16 image into 32x16.
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "asset/MonoImageDecoder.h"
+#include "bench.h"
+#include "utils/XorShift32.hpp"
+
+static std::vector<uint8_t> p4(int w, int h, XorShift32& random) {
+  const std::string header = "P4\n" + std::to_string(w) + " " + std::to_string(h) + "\n";
+  std::vector<uint8_t> file(header.begin(), header.end());
+  const size_t start = file.size();
+  file.resize(start + (w + 7) / 8 * h);
+  for (size_t i = start; i < file.size(); ++i) file[i] = random.next();
+  return file;
+}
+
+int main() {
+  XorShift32 random(50);
+  const std::vector<uint8_t> big = p4(256, 128, random), small = p4(32, 16, random);
+  const uint8_t* pixels = big.data() + big.size() - 256 / 8 * 128;
+  static MonoImageDecoder decoder;
+  GFXcanvas1 same(256, 128), wide(320, 128), tiny(32, 16);
+
+  if (!decoder.decode(big.data(), big.size(), &same, 0, 0) || memcmp(same.getBuffer(), pixels, 256 / 8 * 128)) {
+    printf("P4 decoding is broken\n");
+    return 1;
+  }
+  printf("%-26s %10s %10s\n", "256x128 P4", "decode", "memcpy");
+  double ns = bestNs([&] { decoder.decode(big.data(), big.size(), &same, 0, 0); }, 20000);
+  double copy = bestNs([&] { memcpy(same.getBuffer(), pixels, 256 / 8 * 128); }, 20000);
+  printf("%-26s %7.0f ns %7.0f ns\n", "same width canvas", ns, copy);
+  auto rows = [&] {
+    for (int y = 0; y < 128; ++y) memcpy(wide.getBuffer() + y * wide.getRowBytes(), pixels + y * 256 / 8, 256 / 8);
+  };
+  ns = bestNs([&] { decoder.decode(big.data(), big.size(), &wide, 0, 0); }, 20000);
+  copy = bestNs(rows, 20000);
+  printf("%-26s %7.0f ns %7.0f ns\n", "320 wide canvas", ns, copy);
+  ns = bestNs([&] { decoder.decode(big.data(), big.size(), &wide, 3, 0); }, 2000);
+  printf("%-26s %7.0f ns %7.0f ns\n", "320 wide canvas at x = 3", ns, copy);
+  ns = bestNs([&] { decoder.decode(small.data(), small.size(), &tiny, 0, 0); }, 100000);
+  printf("%-26s %7.0f ns\n", "32x16 P4 into 32x16", ns);
+  return 0;
+}
@@ -0,0 +1,65 @@
+// SpriteList::draw() of 20 masked sprites with random flips on a 32x16 canvas, one of them moving every frame,
+// against the same sprites drawn per pixel with drawPixel(). Also a scrolling TileMap filling the canvas.
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench.h"
+#include "matrix/Sprites.h"
+#include "utils/XorShift32.hpp"
+
+static bool pixel(const std::vector<uint8_t>& data, int size, int tile, int x, int y) {
+  const int rowBytes = (size + 7) / 8;
+  return data[(tile * size + y) * rowBytes + x / 8] & (0x80 >> (x % 8));
+}
+
+int main() {
+  const int kSprites = 20, kTiles = 4;
+  XorShift32 random(47);
+  GFXcanvas1 canvas(32, 16);
+  printf("%-18s %12s %12s\n", "20 sprites", "SpriteList", "drawPixel");
+  for (int size : {8, 16}) {
+    std::vector<uint8_t> bits(kTiles * size * ((size + 7) / 8)), masks(bits.size());
+    for (auto& b : bits) b = random.next();
+    for (auto& b : masks) b = random.next();
+    SpriteSheet sheet(bits.data(), masks.data(), size, size, kTiles);
+    SpriteList list(&sheet);
+    for (int i = 0; i < kSprites; ++i) {
+      const int id = list.add(i % kTiles, random.below(40) - 4, random.below(24) - 4, random.below(8));
+      list.sprite(id)->flags = random.below(4);
+    }
+    int frame = 0;
+    double sprites = bestNs(
+        [&] {
+          list.sprite(frame % kSprites)->x = frame % 40 - 4;
+          ++frame;
+          list.draw(&canvas);
+        },
+        100000);
+    double perPixel = bestNs(
+        [&] {
+          for (int i = 0; i < kSprites; ++i) {
+            const SpriteList::Sprite* s = list.sprite(i);
+            for (int y = 0; y < size; ++y) {
+              for (int x = 0; x < size; ++x) {
+                if (pixel(masks, size, s->tile, x, y)) canvas.drawPixel(s->x + x, s->y + y, pixel(bits, size, s->tile, x, y));
+              }
+            }
+          }
+        },
+        10000);
+    printf("%2dx%-15d %9.0f ns %9.0f ns\n", size, size, sprites, perPixel);
+  }
+
+  // a 16x4 map of 8x8 tiles, scrolled a pixel per frame
+  std::vector<uint8_t> tiles(kTiles * 8);
+  for (auto& b : tiles) b = random.next();
+  SpriteSheet sheet(tiles.data(), nullptr, 8, 8, kTiles);
+  uint8_t cells[16 * 4];
+  for (auto& cell : cells) cell = random.below(5) == 0 ? TileMap::kEmpty : random.below(kTiles);
+  TileMap map(&sheet, cells, 16, 4);
+  int scroll = 0;
+  double scrolled = bestNs([&] { map.draw(&canvas, scroll++ % 96, 8); }, 100000);
+  printf("%-18s %9.0f ns\n", "tile map 32x16", scrolled);
+  return 0;
+}
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Write the 32x16 test animation of bench_gif: 60 frames of a moving gray wave.
+
+    tools/bench/mkgif.py out.gif --colors 2
+
+Every frame covers the whole screen, so each one is a full LZW decode.
+Only the Python standard library is needed.
+"""
+
+import argparse
+import math
+import struct
+
+WIDTH, HEIGHT, FRAMES = 32, 16, 60
+
+
+def lzw(indices, min_size):
+    """GIF LZW code stream of the color indices, without clear codes after the first"""
+    clear = 1 << min_size
+    out, acc, bits = bytearray(), 0, 0
+
+    def emit(code, size):
+        nonlocal acc, bits
+        acc |= code << bits
+        bits += size
+        while bits >= 8:
+            out.append(acc & 0xFF)
+            acc >>= 8
+            bits -= 8
+
+    table, next_code, size = {}, clear + 2, min_size + 1
+    emit(clear, size)
+    prefix = indices[0]
+    for k in indices[1:]:
+        if (prefix, k) in table:
+            prefix = table[(prefix, k)]
+            continue
+        emit(prefix, size)
+        if next_code < 4096:
+            table[(prefix, k)] = next_code
+            if next_code == 1 << size and size < 12:
+                size += 1
+            next_code += 1
+        prefix = k
+    emit(prefix, size)
+    if next_code == 1 << size and size < 12:
+        size += 1
+    emit(clear + 1, size)
+    if bits:
+        out.append(acc & 0xFF)
+    return bytes(out)
+
+
+def sub_blocks(data):
+    out = bytearray()
+    for i in range(0, len(data), 255):
+        out.append(len(data[i:i + 255]))
+        out += data[i:i + 255]
+    return bytes(out + b"\0")
+
+
+def make_gif(colors):
+    depth = max(1, (colors - 1).bit_length())
+    colors = 1 << depth
+    palette = b"".join(bytes([i * 255 // (colors - 1)] * 3) for i in range(colors))
+    gif = bytearray(b"GIF89a" + struct.pack("<HHBBB", WIDTH, HEIGHT, 0x80 | (depth - 1), 0, 0) + palette)
+    min_size = max(2, depth)
+    for f in range(FRAMES):
+        pixels = [int((math.sin(x * 0.4 + f * 0.3) + math.cos(y * 0.5 - f * 0.2) + 2) / 4 * (colors - 1))
+                  for y in range(HEIGHT) for x in range(WIDTH)]
+        gif += b"\x21\xf9\x04\x00\x04\x00\x00\x00"  # graphic control: 40 ms, no disposal
+        gif += b"\x2c" + struct.pack("<HHHHB", 0, 0, WIDTH, HEIGHT, 0)
+        gif += bytes([min_size]) + sub_blocks(lzw(pixels, min_size))
+    return bytes(gif + b"\x3b")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("output", help="GIF file to write")
+    parser.add_argument("--colors", type=int, default=2, help="palette size, 2 - 256 (default 2)")
+    args = parser.parse_args()
+    with open(args.output, "wb") as f:
+        f.write(make_gif(min(256, max(2, args.colors))))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""Build the asset pack image read in place by main/asset/AssetPack.
+
+Animations are given as 1-bit frames, either PBM files (P1 or P4) or text
+files where '#', '*', 'X' or '1' mark a lit pixel and a blank line starts the
+next frame. --frames stores every frame whole, --anim a keyframe and XOR
+deltas for DeltaAnimation, so long animations only cost their changes. GIF
+files are stored as is, GifDecoder plays them. Still images for
+MonoImageDecoder are PBM or XBM files, stored as is, or PNG files, stored as
+PBM (P4) by tools/png2mono.py; PNG frames are taken as well. Fonts are images
+of tools/mkfont.py. See AssetPack.h and DeltaAnimation.h for the layouts.
+
+Example, the two-frame TV of the clock screen and a font:
+
+    tools/mkassets.py -o assets.bin --anim bili_tv 1000 tv.txt --font cjk16 font.bin
+    parttool.py --port /dev/ttyUSB0 write_partition --partition-name assets --input assets.bin
+
+On the host, MappedRegion::mapFile("assets.bin") maps the same image.
+Only the Python standard library is needed.
+"""
+
+import argparse
+import struct
+import sys
+
+import png2mono
+
+MAGIC = b"APAK"
+VERSION = 1
+PARTITION_SIZE = 192 * 1024  # 'assets' in partitions.csv
+MAX_NAME = 15  # AssetPack::kMaxName
+TYPE_RAW, TYPE_FRAMES, TYPE_FONT, TYPE_ANIMATION, TYPE_GIF, TYPE_IMAGE = 0, 1, 2, 3, 4, 5
+LIT = set("#*X1")
+
+
+def fnv1a(name):
+    h = 2166136261
+    for b in name.encode():
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def pbm_tokens(data):
+    """Header tokens of a PBM file and the offset just after the last one"""
+    tokens, i = [], 2
+    while len(tokens) < 2:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b"#":
+            while data[i:i + 1] not in (b"\n", b""):
+                i += 1
+            continue
+        start = i
+        while not data[i:i + 1].isspace():
+            i += 1
+        tokens.append(int(data[start:i]))
+    return tokens, i + 1
+
+
+def read_pbm(path):
+    """One frame as a list of rows, each a list of 0/1"""
+    with open(path, "rb") as f:
+        data = f.read()
+    magic = data[:2]
+    (width, height), pos = pbm_tokens(data)
+    if magic == b"P4":
+        row_bytes = (width + 7) // 8
+        raw = data[pos:pos + row_bytes * height]
+        return [[(raw[y * row_bytes + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    if magic == b"P1":
+        bits = [int(c) for c in data[pos:].decode("ascii") if c in "01"]
+        return [bits[y * width:(y + 1) * width] for y in range(height)]
+    sys.exit("%s: not a P1/P4 PBM file" % path)
+
+
+def read_text(path):
+    """Frames drawn as text, separated by blank lines"""
+    frames, rows = [], []
+    with open(path, encoding="utf-8") as f:
+        for line in f.read().splitlines() + [""]:
+            line = line.rstrip()
+            if line:
+                rows.append([1 if c in LIT else 0 for c in line])
+            elif rows:
+                frames.append(rows)
+                rows = []
+    return frames
+
+
+def read_frames(paths):
+    """The frames of all files as canvas rows, with their width and height"""
+    frames = []
+    for path in paths:
+        if path.endswith(".txt"):
+            frames += read_text(path)
+        elif path.endswith(".png"):
+            frames.append(png2mono.to_bits(path))
+        else:
+            frames.append(read_pbm(path))
+    if not frames:
+        sys.exit("no frames in %s" % " ".join(paths))
+    width = max(len(row) for frame in frames for row in frame)
+    height = max(len(frame) for frame in frames)
+    row_bytes = (width + 7) // 8
+    bitmaps = []
+    for frame in frames:
+        bitmap = bytearray(row_bytes * height)  # smaller frames are padded right/bottom
+        for y, row in enumerate(frame):
+            for x, bit in enumerate(row):
+                if bit:
+                    bitmap[y * row_bytes + x // 8] |= 0x80 >> (x % 8)
+        bitmaps.append(bytes(bitmap))
+    return bitmaps, width, height
+
+
+def pack_frames(paths, frame_ms):
+    frames, width, height = read_frames(paths)
+    out = struct.pack("<HHHH", width, height, len(frames), frame_ms) + b"".join(frames)
+    return out, "%d frames %dx%d" % (len(frames), width, height)
+
+
+def encode_delta(delta):
+    """Ops of one record, the same coding as gfxDeltaEncode() in bitmapbake.h"""
+    out, skip, i, n = bytearray(), 0, 0, len(delta)
+    while i < n:
+        d = delta[i]
+        if not d:
+            skip += 1
+            i += 1
+            continue
+        while skip > 255:
+            out += bytes((255, 128))
+            skip -= 255
+        out.append(skip)
+        skip = 0
+        run = 1
+        while i + run < n and run < 128 and delta[i + run] == d:
+            run += 1
+        if run >= 3:
+            out += bytes((257 - run, d))
+            i += run
+            continue
+        literal = 1
+        while i + literal < n and literal < 128:
+            j = i + literal
+            if not delta[j] and (j + 1 >= n or not delta[j + 1]):
+                break
+            if delta[j] and j + 2 < n and delta[j + 1] == delta[j] == delta[j + 2]:
+                break
+            literal += 1
+        out.append(literal - 1)
+        out += delta[i:i + literal]
+        i += literal
+    return out
+
+
+def pack_animation(paths, frame_ms):
+    frames, width, height = read_frames(paths)
+    if len(frame_ms) < len(frames):  # the last duration holds for the remaining frames
+        frame_ms += frame_ms[-1:] * (len(frames) - len(frame_ms))
+    if min(frame_ms) <= 0 or max(frame_ms) > 0xFFFF:
+        sys.exit("frame durations must be 1 to 65535 ms")
+    out = bytearray(struct.pack("<HHHH", width, height, len(frames), 0))
+    blank = bytes(len(frames[0]))
+    # frame 0 against a blank frame, every frame against the previous one, then back to frame 0
+    for ms, frame, prev in zip(frame_ms + [0], frames + frames[:1], [blank] + frames):
+        ops = encode_delta(bytes(a ^ b for a, b in zip(frame, prev)))
+        if len(ops) > 0xFFFF:
+            sys.exit("a frame of %dx%d is too large to encode" % (width, height))
+        out += struct.pack("<HH", ms, len(ops)) + ops
+    raw = len(frames) * len(blank)
+    return bytes(out), "%d frames %dx%d, %d%% of raw frames" % (len(frames), width, height, 100 * len(out) // raw)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("-o", "--output", required=True, help="pack image to write")
+    parser.add_argument("--frames", nargs="+", action="append", default=[], metavar="ARG",
+                        help="NAME FRAME_MS FILE...: an animation (or a still image) from PBM/text files")
+    parser.add_argument("--anim", nargs="+", action="append", default=[], metavar="ARG",
+                        help="NAME MS[,MS...] FILE...: an animation stored as deltas, with the duration of each frame "
+                        "(the last one holds for the rest)")
+    parser.add_argument("--font", nargs=2, action="append", default=[], metavar=("NAME", "FILE"), help="a font image of tools/mkfont.py")
+    parser.add_argument("--image", nargs=2, action="append", default=[], metavar=("NAME", "FILE"),
+                        help="a still image for MonoImageDecoder: PBM, XBM or PNG (stored as PBM)")
+    parser.add_argument("--gif", nargs=2, action="append", default=[], metavar=("NAME", "FILE"), help="a GIF animation")
+    parser.add_argument("--raw", nargs=2, action="append", default=[], metavar=("NAME", "FILE"), help="any file, as is")
+    parser.add_argument("--max-size", type=int, default=PARTITION_SIZE, help="fail if the image is larger (default: the assets partition)")
+    args = parser.parse_args()
+
+    assets = []  # (name, type, payload, description)
+    for spec in args.frames:
+        if len(spec) < 3:
+            sys.exit("--frames needs NAME FRAME_MS FILE...")
+        payload, desc = pack_frames(spec[2:], int(spec[1]))
+        assets.append((spec[0], TYPE_FRAMES, payload, desc))
+    for spec in args.anim:
+        if len(spec) < 3:
+            sys.exit("--anim needs NAME MS[,MS...] FILE...")
+        payload, desc = pack_animation(spec[2:], [int(ms) for ms in spec[1].split(",")])
+        assets.append((spec[0], TYPE_ANIMATION, payload, desc))
+    for name, path in args.font:
+        with open(path, "rb") as f:
+            payload = f.read()
+        if payload[:4] != b"UFNT":
+            sys.exit("%s: not a font image of tools/mkfont.py" % path)
+        assets.append((name, TYPE_FONT, payload, "font"))
+    for name, path in args.gif:
+        with open(path, "rb") as f:
+            payload = f.read()
+        if payload[:6] not in (b"GIF87a", b"GIF89a"):
+            sys.exit("%s: not a GIF file" % path)
+        width, height = struct.unpack("<HH", payload[6:10])
+        assets.append((name, TYPE_GIF, payload, "GIF %dx%d" % (width, height)))
+    for name, path in args.image:
+        if path.endswith(".png"):
+            bits = png2mono.to_bits(path)
+            payload, desc = png2mono.to_pbm(bits), "PNG %dx%d as PBM" % (len(bits[0]), len(bits))
+        else:
+            with open(path, "rb") as f:
+                payload = f.read()
+            if payload[:2] not in (b"P1", b"P4") and b"#define" not in payload:
+                sys.exit("%s: not a P1/P4 PBM or XBM file" % path)
+            desc = "PBM" if payload[:1] == b"P" else "XBM"
+        assets.append((name, TYPE_IMAGE, payload, desc))
+    for name, path in args.raw:
+        with open(path, "rb") as f:
+            assets.append((name, TYPE_RAW, f.read(), "raw"))
+
+    names = [a[0] for a in assets]
+    for name in names:
+        if not name or len(name.encode()) > MAX_NAME or names.count(name) > 1:
+            sys.exit("asset names must be unique, 1 to %d bytes: %r" % (MAX_NAME, name))
+    assets.sort(key=lambda a: (fnv1a(a[0]), a[0]))
+
+    offset = 12 + 32 * len(assets)
+    index, payloads = bytearray(), bytearray()
+    for name, kind, payload, _ in assets:
+        pad = -(offset + len(payloads)) % 4
+        payloads += bytes(pad)
+        index += struct.pack("<IIIB3x16s", fnv1a(name), offset + len(payloads), len(payload), kind, name.encode())
+        payloads += payload
+    image = MAGIC + struct.pack("<BxHI", VERSION, len(assets), offset + len(payloads)) + index + payloads
+
+    if len(image) > args.max_size:
+        sys.exit("image is %d bytes, more than %d" % (len(image), args.max_size))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    for name, _, payload, desc in assets:
+        print("  %-15s %6d bytes  %s" % (name, len(payload), desc))
+    print("%s: %d assets, %d bytes" % (args.output, len(assets), len(image)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Build the font partition image read by main/font/FontStore from BDF fonts.
+
+Every glyph is placed on a fixed cell (the font bounding box unless --width /
+--height are given) relative to the font baseline, and stored as MSB-first
+packed rows behind a sorted code point index; see FontStore.h for the layout.
+
+Example, 16x16 hanzi limited to GB2312 plus the ASCII of an 8x16 font:
+
+    tools/mkfont.py -o font.bin --charset gb2312 wenquanyi_16.bdf ascii_8x16.bdf
+    parttool.py --port /dev/ttyUSB0 write_partition --partition-name font --input font.bin
+
+On the host, MappedRegion::mapFile("font.bin") maps the same image.
+Only the Python standard library is needed.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"UFNT"
+VERSION = 1
+PARTITION_SIZE = 384 * 1024  # 'font' in partitions.csv
+MAX_GLYPH_BYTES = 3 * 24  # FontStore::kMaxGlyphBytes
+
+
+class Glyph:
+    def __init__(self, codepoint, advance, rows, xoff, yoff, width, height):
+        self.codepoint = codepoint
+        self.advance = advance
+        self.rows = rows  # one int per row, bit (width - 1 - x) is pixel x
+        self.xoff = xoff
+        self.yoff = yoff
+        self.width = width
+        self.height = height
+
+
+class BdfFont:
+    def __init__(self, path, encoding):
+        self.glyphs = []
+        self.bbox = (0, 0, 0, 0)
+        self.ascent = None
+        registry = ""
+        with open(path, encoding="latin-1") as f:
+            lines = iter(f.read().splitlines())
+        for line in lines:
+            words = line.split()
+            if not words:
+                continue
+            key = words[0]
+            if key == "FONTBOUNDINGBOX":
+                self.bbox = tuple(int(v) for v in words[1:5])
+            elif key == "FONT_ASCENT":
+                self.ascent = int(words[1])
+            elif key == "CHARSET_REGISTRY":
+                registry = line.split(None, 1)[1].strip('"').upper()
+            elif key == "STARTCHAR":
+                self._read_char(lines)
+        if self.ascent is None:
+            self.ascent = self.bbox[1] + self.bbox[3]
+
+        if encoding == "auto":
+            if registry.startswith("ISO10646") or registry.startswith("ISO8859"):
+                encoding = "unicode"
+            elif registry.startswith("GB2312"):
+                encoding = "gb2312"
+            else:
+                sys.exit("%s: unknown CHARSET_REGISTRY '%s', pass --encoding" % (path, registry))
+        if encoding == "gb2312":
+            for glyph in self.glyphs:
+                glyph.codepoint = gb2312_to_unicode(glyph.codepoint)
+            self.glyphs = [g for g in self.glyphs if g.codepoint is not None]
+
+    def _read_char(self, lines):
+        codepoint = -1
+        advance = 0
+        bbx = None
+        rows = []
+        for line in lines:
+            words = line.split()
+            if not words:
+                continue
+            key = words[0]
+            if key == "ENCODING":
+                codepoint = int(words[-1])
+            elif key == "DWIDTH":
+                advance = int(words[1])
+            elif key == "BBX":
+                bbx = tuple(int(v) for v in words[1:5])
+            elif key == "BITMAP":
+                for row in lines:
+                    if row.strip() == "ENDCHAR":
+                        break
+                    rows.append(row.strip())
+                break
+        if codepoint < 0 or bbx is None:
+            return
+        width, height, xoff, yoff = bbx
+        bits = []
+        for row in rows[:height]:
+            value = int(row, 16) if row else 0
+            bits.append(value >> (len(row) * 4 - width) if len(row) * 4 >= width else value << (width - len(row) * 4))
+        bits += [0] * (height - len(bits))
+        self.glyphs.append(Glyph(codepoint, advance, bits, xoff, yoff, width, height))
+
+
+def gb2312_to_unicode(code):
+    if code < 0x80:
+        return code
+    try:
+        return ord(bytes([(code >> 8) | 0x80, (code & 0xFF) | 0x80]).decode("gb2312"))
+    except (UnicodeDecodeError, TypeError, ValueError):
+        return None
+
+
+def in_charset(codepoint, charset):
+    if charset is None or codepoint < 0x80:
+        return True
+    try:
+        chr(codepoint).encode(charset)
+        return True
+    except UnicodeEncodeError:
+        return False
+
+
+def pack_glyph(glyph, cell_w, cell_h, ascent):
+    """Place a BDF glyph on the cell and return its packed rows."""
+    row_bytes = (cell_w + 7) // 8
+    out = bytearray(row_bytes * cell_h)
+    top = ascent - (glyph.yoff + glyph.height)
+    for r, value in enumerate(glyph.rows):
+        y = top + r
+        if not 0 <= y < cell_h:
+            continue
+        for c in range(glyph.width):
+            if not (value >> (glyph.width - 1 - c)) & 1:
+                continue
+            x = glyph.xoff + c
+            if 0 <= x < cell_w:
+                out[y * row_bytes + x // 8] |= 0x80 >> (x % 8)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("bdf", nargs="+", help="BDF fonts, earlier ones win for duplicate code points")
+    parser.add_argument("-o", "--output", required=True, help="font image to write")
+    parser.add_argument("--width", type=int, help="cell width (default: first font's bounding box)")
+    parser.add_argument("--height", type=int, help="cell height (default: first font's bounding box)")
+    parser.add_argument("--line-height", type=int, help="yAdvance (default: cell height)")
+    parser.add_argument("--encoding", default="auto", choices=["auto", "unicode", "gb2312"], help="ENCODING values of the BDF files")
+    parser.add_argument("--charset", help="keep only characters encodable in this Python codec, e.g. gb2312 (ASCII always kept)")
+    parser.add_argument("--chars", help="keep only the characters in this UTF-8 text file")
+    parser.add_argument("--max-size", type=int, default=PARTITION_SIZE, help="fail if the image is larger (default: the font partition)")
+    args = parser.parse_args()
+
+    fonts = [BdfFont(path, args.encoding) for path in args.bdf]
+    cell_w = args.width or fonts[0].bbox[0]
+    cell_h = args.height or fonts[0].bbox[1]
+    if (cell_w + 7) // 8 * cell_h > MAX_GLYPH_BYTES:
+        sys.exit("cell %dx%d exceeds FontStore::kMaxGlyphBytes" % (cell_w, cell_h))
+    ascent = fonts[0].ascent
+    wanted = None
+    if args.chars:
+        with open(args.chars, encoding="utf-8") as f:
+            wanted = {ord(ch) for ch in f.read()}
+
+    glyphs = {}
+    for font in fonts:
+        # glyph offsets are relative to the baseline, which all fonts share
+        for glyph in font.glyphs:
+            cp = glyph.codepoint
+            if cp in glyphs or not in_charset(cp, args.charset) or (wanted is not None and cp not in wanted):
+                continue
+            glyphs[cp] = (min(glyph.advance, 255), pack_glyph(glyph, cell_w, cell_h, ascent))
+
+    codepoints = sorted(glyphs)
+    image = bytearray(MAGIC)
+    image += struct.pack("<BBBBI", VERSION, cell_w, cell_h, args.line_height or cell_h, len(codepoints))
+    image += struct.pack("<%dI" % len(codepoints), *codepoints)
+    image += bytes(glyphs[cp][0] for cp in codepoints)
+    for cp in codepoints:
+        image += glyphs[cp][1]
+
+    if len(image) > args.max_size:
+        sys.exit("image is %d bytes, more than %d; subset with --charset/--chars" % (len(image), args.max_size))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d glyphs, %dx%d cell, %d bytes" % (args.output, len(codepoints), cell_w, cell_h, len(image)))
+
+
+if __name__ == "__main__":
+    main()
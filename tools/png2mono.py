@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""Convert a PNG image to a 1-bit PBM (P4) or XBM file.
+
+Pixels are lit when their luminance reaches the threshold, after compositing
+over black (a transparent pixel is off). P4 rows are the canvas row format
+(MSB-first, rows padded to whole bytes), so MonoImageDecoder copies them
+straight into GFXcanvas1 rows; XBM is the C source drawXBitmap() and
+MonoImageDecoder both take. Either file can go into the asset pack with
+tools/mkassets.py --image, which also takes the PNG itself.
+
+Example, a 32x16 logo for the asset pack and as C source:
+
+    tools/png2mono.py logo.png -o logo.pbm
+    tools/png2mono.py logo.png -o logo.xbm --threshold 96 --invert
+
+Every PNG color type, bit depth and interlacing is read.
+Only the Python standard library is needed.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+SIGNATURE = b"\x89PNG\r\n\x1a\n"
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}  # by color type
+# Adam7 passes: x start, y start, x step, y step
+ADAM7 = ((0, 0, 8, 8), (4, 0, 8, 8), (0, 4, 4, 8), (2, 0, 4, 4), (0, 2, 2, 4), (1, 0, 2, 2), (0, 1, 1, 2))
+
+
+def unfilter(data, pos, width, height, bpp, bits_per_pixel):
+    """The height scanlines of width pixels at data[pos:], unfiltered, and the offset after them"""
+    stride = (width * bits_per_pixel + 7) // 8
+    rows, prior = [], bytearray(stride)
+    for _ in range(height):
+        kind = data[pos]
+        line = bytearray(data[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        if kind == 1:
+            for i in range(bpp, stride):
+                line[i] = (line[i] + line[i - bpp]) & 0xFF
+        elif kind == 2:
+            for i in range(stride):
+                line[i] = (line[i] + prior[i]) & 0xFF
+        elif kind == 3:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + ((left + prior[i]) >> 1)) & 0xFF
+        elif kind == 4:
+            for i in range(stride):
+                a = line[i - bpp] if i >= bpp else 0
+                b = prior[i]
+                c = prior[i - bpp] if i >= bpp else 0
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[i] = (line[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xFF
+        elif kind != 0:
+            raise ValueError("bad filter type %d" % kind)
+        rows.append(line)
+        prior = line
+    return rows, pos
+
+
+def samples(line, count, depth):
+    """count samples of depth bits from a scanline, 16-bit ones reduced to their high byte"""
+    if depth == 8:
+        return list(line[:count])
+    if depth == 16:
+        return list(line[0:2 * count:2])
+    per_byte, mask = 8 // depth, (1 << depth) - 1
+    return [(line[i // per_byte] >> (8 - depth * (i % per_byte + 1))) & mask for i in range(count)]
+
+
+def read_png(path):
+    """Width, height and rows of (luminance, alpha) pairs, 0-255"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != SIGNATURE:
+        raise ValueError("not a PNG file")
+    pos, idat, palette, trns, header = 8, bytearray(), None, None, None
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            header = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body) - 2, 3)]
+        elif kind == b"tRNS":
+            trns = body
+        elif kind == b"IDAT":
+            idat += body
+        elif kind == b"IEND":
+            break
+    if not header:
+        raise ValueError("no IHDR chunk")
+    width, height, depth, color, _, _, interlace = header
+    if color not in CHANNELS or (color == 3 and not palette):
+        raise ValueError("unsupported color type %d" % color)
+    channels = CHANNELS[color]
+    bits_per_pixel = channels * depth
+    bpp = max(1, bits_per_pixel // 8)
+    raw = zlib.decompress(bytes(idat))
+
+    # raw samples of every pixel, interlaced passes scattered into place
+    pixels = [[None] * width for _ in range(height)]
+    passes = ADAM7 if interlace else ((0, 0, 1, 1),)
+    pos = 0
+    for x0, y0, dx, dy in passes:
+        w, h = (width - x0 + dx - 1) // dx, (height - y0 + dy - 1) // dy
+        if w <= 0 or h <= 0:
+            continue
+        rows, pos = unfilter(raw, pos, w, h, bpp, bits_per_pixel)
+        for j, line in enumerate(rows):
+            values = samples(line, w * channels, depth)
+            for i in range(w):
+                pixels[y0 + j * dy][x0 + i * dx] = values[i * channels:(i + 1) * channels]
+
+    scale = 255 // ((1 << depth) - 1) if depth < 8 and color != 3 else 1
+    key = None
+    if trns and color in (0, 2):
+        # one transparent color, compared in the reduced sample range
+        words = struct.unpack(">%dH" % (len(trns) // 2), trns)
+        key = [w >> 8 if depth == 16 else w for w in words]
+    out = []
+    for row in pixels:
+        line = []
+        for s in row:
+            if color == 3:
+                r, g, b = palette[s[0]]
+                alpha = trns[s[0]] if trns and s[0] < len(trns) else 255
+            else:
+                alpha = 0 if key is not None and list(s[:len(key)]) == key else 255
+                if color in (4, 6):
+                    alpha = s[-1]
+                if color in (0, 4):
+                    r = g = b = s[0] * scale
+                else:
+                    r, g, b = s[0], s[1], s[2]
+            # Rec. 601 luma, as GifDecoder
+            line.append(((r * 77 + g * 150 + b * 29) >> 8, alpha))
+        out.append(line)
+    return width, height, out
+
+
+def to_bits(path, threshold=128, invert=False):
+    """The PNG as rows of 0/1, lit where the luminance over black reaches the threshold"""
+    width, height, rows = read_png(path)
+    bits = []
+    for row in rows:
+        line = []
+        for luma, alpha in row:
+            lit = luma * alpha // 255 >= threshold
+            line.append(int(lit != invert))
+        bits.append(line)
+    return bits
+
+
+def pack_rows(bits, lsb_first=False):
+    """Rows padded to whole bytes, leftmost pixel in the high bit (or the low bit, for XBM)"""
+    out = bytearray()
+    for row in bits:
+        line = bytearray((len(row) + 7) // 8)
+        for x, bit in enumerate(row):
+            if bit:
+                line[x // 8] |= (1 << (x % 8)) if lsb_first else (0x80 >> (x % 8))
+        out += line
+    return bytes(out)
+
+
+def to_pbm(bits):
+    return b"P4\n%d %d\n" % (len(bits[0]), len(bits)) + pack_rows(bits)
+
+
+def to_xbm(bits, name):
+    data = pack_rows(bits, lsb_first=True)
+    lines = ["#define %s_width %d" % (name, len(bits[0])), "#define %s_height %d" % (name, len(bits)),
+             "static unsigned char %s_bits[] = {" % name]
+    for i in range(0, len(data), 12):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 12]) + ("," if i + 12 < len(data) else ""))
+    lines.append("};")
+    return ("\n".join(lines) + "\n").encode()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("input", help="PNG image")
+    parser.add_argument("-o", "--output", required=True, help="file to write, .xbm for XBM, PBM (P4) otherwise")
+    parser.add_argument("--threshold", type=int, default=128, help="luminance (0-255) from which a pixel is lit (default 128)")
+    parser.add_argument("--invert", action="store_true", help="light the dark pixels instead")
+    parser.add_argument("--name", help="XBM name (default: the output file name)")
+    args = parser.parse_args()
+
+    try:
+        bits = to_bits(args.input, args.threshold, args.invert)
+    except (ValueError, zlib.error, struct.error, IndexError) as e:
+        sys.exit("%s: %s" % (args.input, e if str(e) else "broken PNG file"))
+    if args.output.endswith(".xbm"):
+        name = args.name or os.path.splitext(os.path.basename(args.output))[0].replace("-", "_")
+        out = to_xbm(bits, name)
+    else:
+        out = to_pbm(bits)
+    with open(args.output, "wb") as f:
+        f.write(out)
+    lit = sum(map(sum, bits))
+    print("%s: %dx%d, %d of %d pixels lit" % (args.output, len(bits[0]), len(bits), lit, len(bits[0]) * len(bits)))
+
+
+if __name__ == "__main__":
+    main()